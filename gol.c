@@ -1,19 +1,41 @@
 #include "gol.h"
+#include "gol_kernel.h"
+#include "gol_thread.h"
+#include "gol_snapshot.h"
+#include "gol_gpu.h"
+#include "gol_alloc.h"
 
 #include <stdlib.h>
 #include <memory.h>
+#include <string.h>
+#if GOL_STATS && defined(_WIN32)
+#include <windows.h>
+#elif GOL_STATS
+#include <time.h>
+#endif
 
 // PRIVATE
 // Converts a 2d coordinate to a 1d coordinate using the game's length and width
 // This function doesn't return any errors, instead returns the 1d coordinate
-static inline unsigned int gol_2dto1d(struct gameoflife *game, const gol_pos x, const gol_pos y) {
-    return (y * game->cols) + x;
+static inline size_t gol_2dto1d(const struct gameoflife *game, const gol_pos x, const gol_pos y) {
+    return ((size_t)y * (size_t)game->cols) + (size_t)x;
 }
 
 // PRIVATE
-// Provides the number of live neighbors (in a 3x3 around the cell position) in the count parameter
-// Possbile Errors (return value): GOL_ERR_INIT, GOL_ERR_OK
-static int gol_countlive(struct gameoflife *game, gol_pos x, gol_pos y, int *count) {
+// Provides the cell at any position up to one cell off a byte board, positions off the board read from the halo
+static inline bool gol_halocell(const struct gameoflife *game, gol_pos x, gol_pos y) {
+    if (y < 0) return game->halo_top[x + 1];
+    if (y >= game->rows) return game->halo_bottom[x + 1];
+    if (x < 0) return game->halo_west[y];
+    if (x >= game->cols) return game->halo_east[y];
+    return game->board[gol_2dto1d(game, x, y)];
+}
+
+// PRIVATE
+// Provides the number of live neighbors (in a 3x3 around the cell position), cells off the board are read from the halo
+// Only used for the outer ring of the board, everything inside of it goes through the unchecked interior loop
+// Returns: The number of live neighbors
+static int gol_countlive(const struct gameoflife *game, gol_pos x, gol_pos y) {
     // all possible relative positions of neighbors (x, y)
     const static gol_pos neighbors[][2] = {
             {-1, -1},
@@ -26,39 +48,370 @@ static int gol_countlive(struct gameoflife *game, gol_pos x, gol_pos y, int *cou
             {1,  1},
     };
 
-    if (game->board == NULL) return GOL_ERR_INIT;
-
     // the kept count of live neighbors
     int n = 0;
     // go through all pairs of neighbors
-    for (int i = 0; i < sizeof(neighbors) / sizeof(gol_pos[2]); i++) {
-        // find the positions of the neighbor
-        gol_pos nx = x + neighbors[i][0];
-        gol_pos ny = y + neighbors[i][1];
+    for (int i = 0; i < sizeof(neighbors) / sizeof(gol_pos[2]); i++)
+        n += gol_halocell(game, x + neighbors[i][0], y + neighbors[i][1]);
+
+    return n;
+}
+
+// PRIVATE
+// Maps a coordinate up to one cell off the board (on an axis of n cells) back onto it according to the boundary mode
+// Returns: The coordinate on the board, or -1 if the cell is dead
+static inline gol_pos gol_wrap(gol_boundary boundary, gol_pos v, gol_pos n) {
+    if (v >= 0 && v < n) return v;
+    if (boundary == GOL_BOUNDARY_TORUS) return v < 0 ? v + n : v - n;
+    if (boundary == GOL_BOUNDARY_MIRROR) return v < 0 ? 0 : n - 1;
+    return -1;
+}
+
+// PRIVATE
+// Provides a pointer to the first word of row y in a packed board buffer
+static inline uint64_t *gol_packedrow(const struct gameoflife *game, uint64_t *buf, gol_pos y) {
+    return buf + (size_t)y * game->words;
+}
+
+// PRIVATE
+// Hashes a group of 64 cells, the cells of word w of row y of a packed board (or the same cells of a byte board)
+// A board hashes to the xor of all its groups, with dead groups hashing to 0, in the manner of zobrist hashing (but a
+// key per value of a word instead of per cell) so a group that changes changes the hash by its old and new hash alone
+static inline uint64_t gol_hashword(const struct gameoflife *game, gol_pos y, size_t w, uint64_t cells) {
+    return cells != 0 ? gol_random(cells, (uint64_t)y * game->words + w) : 0;
+}
+
+// PRIVATE
+// Packs up to 64 cells of a byte board into a word, like the word of a packed row
+static inline uint64_t gol_packcells(const bool *cells, size_t count) {
+    const unsigned char *bytes_of = (const unsigned char *) cells;
+    const uint16_t probe = 1;
+    const bool little = *(const unsigned char *) &probe == 1;
+    uint64_t word = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t bytes = 0;
+        // a single load on little endian machines, byte 0 is the lowest then
+        if (little) memcpy(&bytes, bytes_of + i, sizeof(bytes));
+        else for (unsigned int b = 0; b < 8; b++)
+            bytes |= (uint64_t)bytes_of[i + b] << (8 * b);
+        // every byte is 0 or 1, so the multiply gathers byte b into bit 56 + b without any carries
+        word |= ((bytes * 0x0102040810204080ull) >> 56) << i;
+    }
+    for (; i < count; i++)
+        word |= (uint64_t)cells[i] << i;
+    return word;
+}
+
+// PRIVATE
+// Provides the rows [y0, y1) of the band worker 'worker' of 'workers' ticks, the same rows every tick: bands of whole
+// tiles with tile tracking, equal bands of rows without
+static void gol_bandrows(const struct gameoflife *game, unsigned int worker, unsigned int workers, gol_pos *y0,
+                         gol_pos *y1) {
+    if (game->tile_changed != NULL) {
+        size_t ty0 = game->tiles_y * worker / workers, ty1 = game->tiles_y * (worker + 1) / workers;
+        *y0 = (gol_pos)(ty0 * GOL_TILE) < game->rows ? (gol_pos)(ty0 * GOL_TILE) : game->rows;
+        *y1 = (gol_pos)(ty1 * GOL_TILE) < game->rows ? (gol_pos)(ty1 * GOL_TILE) : game->rows;
+        return;
+    }
+    *y0 = (gol_pos)((size_t)game->rows * worker / workers);
+    *y1 = (gol_pos)((size_t)game->rows * (worker + 1) / workers);
+}
+
+// PRIVATE
+// Zeroes the rows of both buffers of the board the worker ticks (see gol_bandrows), so their pages are first touched
+// by the thread that ticks them, which places them on its numa node. the zeroed row after a packed buffer goes with
+// the last band
+static void gol_touchband(void *arg, unsigned int worker, unsigned int workers) {
+    struct gameoflife *game = (struct gameoflife *) arg;
+    gol_pos y0, y1;
+    gol_bandrows(game, worker, workers, &y0, &y1);
+    if (game->storage == GOL_STORAGE_PACKED) {
+        size_t end = worker == workers - 1 ? (size_t)game->rows + 1 : (size_t)y1;
+        memset(game->packed + (size_t)y0 * game->words, 0, (end - (size_t)y0) * game->words * sizeof(uint64_t));
+        memset(game->packed_back + (size_t)y0 * game->words, 0, (end - (size_t)y0) * game->words * sizeof(uint64_t));
+        return;
+    }
+    memset(game->board + gol_2dto1d(game, 0, y0), 0, (size_t)(y1 - y0) * (size_t)game->cols * sizeof(bool));
+    memset(game->back + gol_2dto1d(game, 0, y0), 0, (size_t)(y1 - y0) * (size_t)game->cols * sizeof(bool));
+}
 
-        // if this exceeds the bounds of the board, continue
-        if (nx < 0 || nx >= game->cols || ny < 0 || ny >= game->rows) continue;
+// PRIVATE
+// Zeroes both buffers of the board, on the workers that tick them
+static void gol_touchboards(struct gameoflife *game) {
+    if (game->pool != NULL)
+        gol_pool_run(game->pool, gol_touchband, game);
+    else
+        gol_touchband(game, 0, 1);
+}
+
+// PRIVATE
+// Allocates the two buffers (board and back) for the storage the game was configured with, and the halo around them
+// The buffers are zeroed by the workers of the game (see gol_touchband), so the pool and tiles must be set up first
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_allocboards(struct gameoflife *game) {
+    // the halo starts out dead, it's only refreshed by gol_tick for the other boundary modes
+    game->halo_west = (bool *) gol_zalloc(&game->allocator, (size_t)game->rows + 1, sizeof(bool));
+    game->halo_east = (bool *) gol_zalloc(&game->allocator, (size_t)game->rows + 1, sizeof(bool));
+    if (game->halo_west == NULL || game->halo_east == NULL) return GOL_ERR_NOMEM;
 
-        n += game->board[gol_2dto1d(game, nx, ny)];
+    if (game->storage == GOL_STORAGE_PACKED) {
+        // one extra zeroed row is allocated after each buffer, so the ghost row below the
+        // last row (and above the first row) can be read without any bounds checks
+        size_t sz = ((size_t)game->rows + 1) * game->words;
+        uint64_t *packed = (uint64_t *) gol_alloc(&game->allocator, sz, sizeof(uint64_t));
+        if (packed == NULL) return GOL_ERR_NOMEM;
+        uint64_t *packed_back = (uint64_t *) gol_alloc(&game->allocator, sz, sizeof(uint64_t));
+        if (packed_back == NULL) {
+            gol_dealloc(&game->allocator, packed);
+            return GOL_ERR_NOMEM;
+        }
+        game->packed = packed;
+        game->packed_back = packed_back;
+        gol_touchboards(game);
+        return GOL_ERR_OK;
     }
 
-    *count = n;
+    // packed boards use rows of the board itself as the halo above and below, byte boards get their own
+    game->halo_top = (bool *) gol_zalloc(&game->allocator, (size_t)game->cols + 2, sizeof(bool));
+    game->halo_bottom = (bool *) gol_zalloc(&game->allocator, (size_t)game->cols + 2, sizeof(bool));
+    if (game->halo_top == NULL || game->halo_bottom == NULL) return GOL_ERR_NOMEM;
+
+    size_t sz = (size_t)game->rows * game->cols;
+    bool *board = (bool *) gol_alloc(&game->allocator, sz, sizeof(bool));
+    if (board == NULL) return GOL_ERR_NOMEM;
+    bool *back = (bool *) gol_alloc(&game->allocator, sz, sizeof(bool));
+    if (back == NULL) {
+        gol_dealloc(&game->allocator, board);
+        return GOL_ERR_NOMEM;
+    }
+    game->board = board;
+    game->back = back;
+    gol_touchboards(game);
     return GOL_ERR_OK;
 }
 
+// PRIVATE
+// Allocates the tile flags of a game with tile tracking, every tile starts out as changed so the first tick visits all of them
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_alloctiles(struct gameoflife *game) {
+    game->tiles_x = ((size_t)game->cols + GOL_TILE - 1) / GOL_TILE;
+    game->tiles_y = ((size_t)game->rows + GOL_TILE - 1) / GOL_TILE;
+    size_t tiles = game->tiles_x * game->tiles_y;
+
+    game->tile_changed = (bool *) gol_alloc(&game->allocator, tiles, sizeof(bool));
+    if (game->tile_changed == NULL) return GOL_ERR_NOMEM;
+    game->tile_active = (bool *) gol_zalloc(&game->allocator, tiles, sizeof(bool));
+    if (game->tile_active == NULL) return GOL_ERR_NOMEM;
+    memset(game->tile_changed, true, tiles * sizeof(bool));
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Cells counted by one worker during a tick, padded to a cache line so that no two workers write to the same one
+struct gol_tickcount {
+    uint64_t population;
+    uint64_t births;
+    uint64_t deaths;
+    // the keys of every cell that changed, xor-ed together
+    uint64_t hash;
+    uint64_t padding[4];
+};
+
+// one generation in the history of a board
+struct gol_history {
+    uint64_t hash;
+    uint64_t generation;
+};
+
+// PRIVATE
+// Allocates the zeroed counts of every worker of the game, for gol_stats and the board hash
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_alloccounts(struct gameoflife *game) {
+    unsigned int workers = game->pool != NULL ? gol_pool_size(game->pool) : 1;
+    game->tickcounts = (struct gol_tickcount *) gol_zalloc(&game->allocator, workers, sizeof(struct gol_tickcount));
+    return game->tickcounts == NULL ? GOL_ERR_NOMEM : GOL_ERR_OK;
+}
+
+// PRIVATE
+// Allocates the history ring of a game, which starts out empty
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_allochistory(struct gameoflife *game, size_t size) {
+    game->history = (struct gol_history *) gol_zalloc(&game->allocator, size, sizeof(struct gol_history));
+    if (game->history == NULL) return GOL_ERR_NOMEM;
+    game->history_size = size;
+    game->history_count = 0;
+    game->history_next = 0;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Reads the neighbor counts of one half of a rule, a run of digits 0 to 8, into a bit mask
+// Returns: The first character after the digits
+static const char *gol_parsecounts(const char *notation, uint16_t *counts) {
+    for (; *notation >= '0' && *notation <= '9'; notation++) {
+        if (*notation == '9') return notation;
+        *counts |= (uint16_t) (1u << (*notation - '0'));
+    }
+    return notation;
+}
+
+// Compiles a rule in B/S notation into its neighbor count masks and lookup table
+// Accepts "B36/S23" and "S23/B36" with the letters in either case, or the older S/B notation without letters ("23/36")
+// Possible errors (return value): GOL_ERR_RANGE (not a valid rule), GOL_ERR_OK
+gol_err gol_parserule(const char *notation, struct gol_rule *rule) {
+    uint16_t birth = 0, survive = 0;
+    if (notation == NULL) return GOL_ERR_RANGE;
+
+    if ((*notation >= '0' && *notation <= '9') || *notation == '/') {
+        notation = gol_parsecounts(notation, &survive);
+        if (*notation++ != '/') return GOL_ERR_RANGE;
+        notation = gol_parsecounts(notation, &birth);
+    } else {
+        bool seen_birth = false, seen_survive = false;
+        for (int half = 0; half < 2; half++) {
+            if (half == 1 && *notation++ != '/') return GOL_ERR_RANGE;
+            char letter = *notation++;
+            if ((letter == 'B' || letter == 'b') && !seen_birth) {
+                seen_birth = true;
+                notation = gol_parsecounts(notation, &birth);
+            } else if ((letter == 'S' || letter == 's') && !seen_survive) {
+                seen_survive = true;
+                notation = gol_parsecounts(notation, &survive);
+            } else {
+                return GOL_ERR_RANGE;
+            }
+        }
+    }
+    if (*notation != '\0') return GOL_ERR_RANGE;
+
+    rule->birth = birth;
+    rule->survive = survive;
+    for (int n = 0; n <= 8; n++) {
+        rule->next[0][n] = (birth >> n) & 1;
+        rule->next[1][n] = (survive >> n) & 1;
+    }
+    rule->conway = birth == gol_conway.birth && survive == gol_conway.survive;
+    return GOL_ERR_OK;
+}
+
+// Writes a rule in B/S notation (e.g. "B36/S23") into 'dest', which must hold at least GOL_RULE_MAX characters
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_rulestring(const struct gol_rule *rule, char *dest) {
+    *dest++ = 'B';
+    for (int n = 0; n <= 8; n++) {
+        if ((rule->birth >> n) & 1) *dest++ = (char) ('0' + n);
+    }
+    *dest++ = '/';
+    *dest++ = 'S';
+    for (int n = 0; n <= 8; n++) {
+        if ((rule->survive >> n) & 1) *dest++ = (char) ('0' + n);
+    }
+    *dest = '\0';
+    return GOL_ERR_OK;
+}
+
+// Replaces the rule of the game, which takes effect from the next tick on
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (not a valid rule), GOL_ERR_OK
+gol_err gol_setrule(struct gameoflife *game, const char *notation) {
+    gol_err error;
+    struct gol_rule rule;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if ((error = gol_parserule(notation, &rule)) != GOL_ERR_OK) return error;
+    game->rule = rule;
+    // the stable tiles of the old rule may well change under the new one
+    return gol_markdirty(game);
+}
+
 // Initializes the gameoflife struct pointer with the length and width provided
 // Assumes that the gameoflife struct pointer is already initialized, however allocated memory for the internal board pointer
-// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+// Both the board and the back buffer used by gol_tick are allocated here, so ticking never has to allocate
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_OK
 gol_err gol_init(struct gameoflife *game, gol_pos rows, gol_pos cols) {
-    // create board in memory
-    size_t sz = (size_t)rows * cols;
-    bool *board = (bool *) calloc(sz, sizeof(bool));
-    if (board == NULL) return GOL_ERR_NOMEM;
+    return gol_init_opts(game, rows, cols, NULL);
+}
+
+// Initializes the gameoflife struct pointer like gol_init, with the settings provided in opts
+// A NULL opts (or a zeroed struct) uses the defaults, which is a byte-per-cell board
+// Dimensions are 64-bit, they are only limited by what fits in memory (GOL_ERR_RANGE for negative or unaddressable sizes)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_init_opts(struct gameoflife *game, gol_pos rows, gol_pos cols, const struct gol_options *opts) {
+    gol_err error;
+    gol_storage storage = opts != NULL ? opts->storage : GOL_STORAGE_BYTES;
+    unsigned int threads = opts != NULL ? opts->threads : 0;
+    bool tiles = opts != NULL && opts->tiles;
+    gol_boundary boundary = opts != NULL ? opts->boundary : GOL_BOUNDARY_DEAD;
+    const char *notation = opts != NULL && opts->rule != NULL ? opts->rule : GOL_RULE_CONWAY;
+    struct gol_rule rule;
+    if (storage != GOL_STORAGE_BYTES && storage != GOL_STORAGE_PACKED) return GOL_ERR_RANGE;
+    if (boundary > GOL_BOUNDARY_MIRROR) return GOL_ERR_RANGE;
+    gol_backend backend = opts != NULL ? opts->backend : GOL_BACKEND_CPU;
+    if (backend != GOL_BACKEND_CPU && backend != GOL_BACKEND_GPU) return GOL_ERR_RANGE;
+    gol_pinning pin = opts != NULL ? opts->pin : GOL_PIN_NONE;
+    if (pin > GOL_PIN_NODES) return GOL_ERR_RANGE;
+    struct gol_allocator allocator;
+    if ((error = gol_allocator_init(&allocator, opts != NULL ? opts->allocator : NULL)) != GOL_ERR_OK) return error;
+    if ((error = gol_parserule(notation, &rule)) != GOL_ERR_OK) return error;
+    // the board (and the string gol_tostring makes of it) must be addressable with a size_t
+    if (rows < 0 || cols < 0) return GOL_ERR_RANGE;
+    if (cols > 0 && (size_t)rows > (SIZE_MAX - 1) / ((size_t)cols + 1)) return GOL_ERR_RANGE;
 
     // set properties
+    memset(game, 0, sizeof(struct gameoflife));
     game->rows = rows;
     game->cols = cols;
-    game->board = board;
+    game->storage = storage;
+    game->boundary = boundary;
+    game->rule = rule;
+    game->allocator = allocator;
+    game->words = ((size_t)cols + 63) / 64;
+    // the board starts out empty
+    game->population_known = true;
+    game->hash_known = true;
+
+    // start the worker pool once, it's reused by every tick until gol_free
+    if (threads > 1) {
+        if ((error = gol_pool_create(&game->pool, threads, pin, &game->allocator)) != GOL_ERR_OK) {
+            gol_free(game);
+            return error;
+        }
+    }
+
+    // tile tracking is optional, the flags cost one byte per 64x64 cells
+    if (tiles) {
+        if ((error = gol_alloctiles(game)) != GOL_ERR_OK) {
+            gol_free(game);
+            return error;
+        }
+    }
+
+    // create board and back buffer in memory, zeroed by the workers and split like the tiles, so both come first
+    if ((error = gol_allocboards(game)) != GOL_ERR_OK) {
+        gol_free(game);
+        return error;
+    }
+
+    // statistics and the history are optional, the workers each count into a cache line of their own
+    game->counting = GOL_STATS && opts != NULL && opts->stats;
+    unsigned int history = opts != NULL ? opts->history : 0;
+    if (game->counting || history > 0) {
+        if ((error = gol_alloccounts(game)) != GOL_ERR_OK) {
+            gol_free(game);
+            return error;
+        }
+    }
+    if (history > 0) {
+        if ((error = gol_allochistory(game, history)) != GOL_ERR_OK) {
+            gol_free(game);
+            return error;
+        }
+    }
+
+    // the gpu is only a preference, a board it can't tick (or no gpu at all) stays on the cpu
+    if (backend == GOL_BACKEND_GPU && storage == GOL_STORAGE_PACKED && !tiles && history == 0 && rows > 0 && cols > 0) {
+        if (gol_gpu_create(&game->gpu, game) != GOL_ERR_OK)
+            game->gpu = NULL;
+    }
 
     // no other errors to report, and we're done
     return GOL_ERR_OK;
@@ -68,9 +421,41 @@ gol_err gol_init(struct gameoflife *game, gol_pos rows, gol_pos cols) {
 // This does not free the gameoflife struct itself, since it can be contained on the stack
 // Possible errors (return value): GOL_ERR_OK
 gol_err gol_free(struct gameoflife *game) {
-    // free game board if it exists
+    // free game board and back buffer if they exist
     if (game->board)
-        free(game->board);
+        gol_dealloc(&game->allocator, game->board);
+    if (game->back)
+        gol_dealloc(&game->allocator, game->back);
+    // a mapped snapshot is one of the packed buffers, and is unmapped instead
+    if (game->packed && game->packed != game->mapped)
+        gol_dealloc(&game->allocator, game->packed);
+    if (game->packed_back && game->packed_back != game->mapped)
+        gol_dealloc(&game->allocator, game->packed_back);
+    if (game->mapping)
+        gol_snapshot_unmap(game->mapping, game->mapping_size);
+    if (game->halo_top)
+        gol_dealloc(&game->allocator, game->halo_top);
+    if (game->halo_bottom)
+        gol_dealloc(&game->allocator, game->halo_bottom);
+    if (game->halo_west)
+        gol_dealloc(&game->allocator, game->halo_west);
+    if (game->halo_east)
+        gol_dealloc(&game->allocator, game->halo_east);
+    if (game->tile_changed)
+        gol_dealloc(&game->allocator, game->tile_changed);
+    if (game->tile_active)
+        gol_dealloc(&game->allocator, game->tile_active);
+    if (game->scratch)
+        gol_dealloc(&game->allocator, game->scratch);
+    if (game->tickcounts)
+        gol_dealloc(&game->allocator, game->tickcounts);
+    if (game->history)
+        gol_dealloc(&game->allocator, game->history);
+    if (game->gpu)
+        gol_gpu_destroy(game->gpu);
+    // stop the worker threads if there are any
+    if (game->pool)
+        gol_pool_destroy(game->pool);
     // reset values inside structure
     memset(game, 0, sizeof(struct gameoflife));
 
@@ -78,124 +463,1351 @@ gol_err gol_free(struct gameoflife *game) {
 }
 
 // Copies an instance of one gameoflife struct (src) into another (dest)
-// This also allocates a completely new board, so the two structs won't be using the same board memory segment
+// This also allocates a completely new board and back buffer, so the two structs won't be using the same board memory segment
 // Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
 gol_err gol_copy(struct gameoflife *dest, const struct gameoflife *src) {
+    gol_err error;
+    if ((error = gol_sync(src)) != GOL_ERR_OK) return error;
+
     // copy over the src internals of the structure to the destination
     memcpy(dest, src, sizeof(struct gameoflife));
+    dest->board = NULL;
+    dest->back = NULL;
+    dest->packed = NULL;
+    dest->packed_back = NULL;
+    dest->halo_top = NULL;
+    dest->halo_bottom = NULL;
+    dest->halo_west = NULL;
+    dest->halo_east = NULL;
+    // the worker pool isn't shared either, the copy ticks serially
+    dest->pool = NULL;
+    dest->tile_changed = NULL;
+    dest->tile_active = NULL;
+    dest->scratch = NULL;
+    dest->scratch_size = 0;
+    // the copy lives in memory of its own, even if the source is a mapped snapshot
+    dest->mapping = NULL;
+    dest->mapping_size = 0;
+    dest->mapped = NULL;
+    dest->tickcounts = NULL;
+    dest->history = NULL;
+    // and the copy ticks on the cpu
+    dest->gpu = NULL;
+    if (src->board == NULL && src->packed == NULL) return GOL_ERR_OK;
 
-    // create a new board pointer since it's would be bad if they both used
+    // create new board pointers since it's would be bad if they both used
     // the same segment of memory for their operations
-    if (src->board != NULL) {
-        size_t board_len = (size_t)src->cols * src->rows;
-        bool *board_copy = (bool *) malloc(board_len * sizeof(bool));
-        if (board_copy == NULL) return GOL_ERR_NOMEM;
-        memcpy(board_copy, src->board, board_len * sizeof(bool));
-        dest->board = board_copy;
+    if ((error = gol_allocboards(dest)) != GOL_ERR_OK) return error;
+    // the back buffer of the copy is blank, so all of its tiles have to be ticked again
+    if (src->tile_changed != NULL && (error = gol_alloctiles(dest)) != GOL_ERR_OK) return error;
+    if (src->tickcounts != NULL && (error = gol_alloccounts(dest)) != GOL_ERR_OK) return error;
+    // the copy has the same past as the source
+    if (src->history != NULL) {
+        if ((error = gol_allochistory(dest, src->history_size)) != GOL_ERR_OK) return error;
+        memcpy(dest->history, src->history, src->history_size * sizeof(struct gol_history));
+        dest->history_count = src->history_count;
+        dest->history_next = src->history_next;
     }
+    if (src->storage == GOL_STORAGE_PACKED)
+        memcpy(dest->packed, src->packed, (size_t)src->rows * src->words * sizeof(uint64_t));
+    else
+        memcpy(dest->board, src->board, (size_t)src->cols * src->rows * sizeof(bool));
 
     return GOL_ERR_OK;
 }
 
-// Populates the gameoflife struct board with random values (either 1 or 0) at each position
+// Provides the bytes of memory held by the game: both buffers of the board, the halo, the tile flags and the scratch
+// buffers of gol_tick_n. a mapped snapshot counts as much as the board it holds
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_memory(const struct gameoflife *game, size_t *bytes) {
+    size_t total = 0;
+    if (game->storage == GOL_STORAGE_PACKED && game->packed != NULL)
+        total += 2 * ((size_t)game->rows + 1) * game->words * sizeof(uint64_t);
+    if (game->storage == GOL_STORAGE_BYTES && game->board != NULL)
+        total += 2 * (size_t)game->rows * (size_t)game->cols * sizeof(bool)
+                 + 2 * ((size_t)game->cols + 2) * sizeof(bool);
+    if (game->halo_west != NULL)
+        total += 2 * ((size_t)game->rows + 1) * sizeof(bool);
+    if (game->tile_changed != NULL)
+        total += 2 * game->tiles_x * game->tiles_y * sizeof(bool);
+    if (game->tickcounts != NULL)
+        total += (game->pool != NULL ? gol_pool_size(game->pool) : 1) * sizeof(struct gol_tickcount);
+    total += game->history_size * sizeof(struct gol_history);
+    if (game->gpu != NULL)
+        total += gol_gpu_memory(game->gpu);
+    *bytes = total + game->scratch_size;
+    return GOL_ERR_OK;
+}
+
+// Brings the board in host memory up to date with the one on the gpu, if the game ticks on one and it's ahead
+// Every function of the library reading or writing the board calls this itself, it's only needed before reading
+// 'packed' directly, or before writing it (followed by gol_markdirty) so the cells around the ones written are current
+// Possible errors (return value): GOL_ERR_IO (the gpu failed), GOL_ERR_OK
+gol_err gol_sync(const struct gameoflife *game) {
+    return game->gpu != NULL ? gol_gpu_sync(game->gpu, game) : GOL_ERR_OK;
+}
+
+// Provides the name of the device the board ticks on, which is "cpu" unless gol_options.backend asked for a gpu and
+// the board could tick on one
+const char *gol_backendname(const struct gameoflife *game) {
+    return game->gpu != NULL ? gol_gpu_name(game->gpu) : "cpu";
+}
+
+// Reads the value of the cell at the provided coordinates into 'alive'
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_getcell(const struct gameoflife *game, gol_pos x, gol_pos y, bool *alive) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || x >= game->cols || y < 0 || y >= game->rows) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    if (game->storage == GOL_STORAGE_PACKED)
+        *alive = (gol_packedrow(game, game->packed, y)[x / 64] >> (x % 64)) & 1;
+    else
+        *alive = game->board[gol_2dto1d(game, x, y)];
+    return GOL_ERR_OK;
+}
+
+// Sets the value of the cell at the provided coordinates
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_setcell(struct gameoflife *game, gol_pos x, gol_pos y, bool alive) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || x >= game->cols || y < 0 || y >= game->rows) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    bool was_alive;
+    if (game->storage == GOL_STORAGE_PACKED) {
+        uint64_t *word = &gol_packedrow(game, game->packed, y)[x / 64];
+        uint64_t bit = (uint64_t)1 << (x % 64);
+        was_alive = (*word & bit) != 0;
+        *word = alive ? (*word | bit) : (*word & ~bit);
+    } else {
+        bool *cell = &game->board[gol_2dto1d(game, x, y)];
+        was_alive = *cell;
+        *cell = alive;
+    }
+    if (game->population_known)
+        game->population = game->population + alive - was_alive;
+    if (game->hash_known && alive != was_alive) {
+        size_t w = (size_t)x / 64;
+        uint64_t cells;
+        if (game->storage == GOL_STORAGE_PACKED) {
+            cells = gol_packedrow(game, game->packed, y)[w];
+        } else {
+            size_t x0 = w * 64, count = (size_t)game->cols - x0 < 64 ? (size_t)game->cols - x0 : 64;
+            cells = gol_packcells(game->board + gol_2dto1d(game, (gol_pos)x0, y), count);
+        }
+        game->hash ^= gol_hashword(game, y, w, cells) ^ gol_hashword(game, y, w, cells ^ ((uint64_t)1 << (x % 64)));
+    }
+    // the board isn't the one any earlier generation led to anymore
+    game->history_count = 0;
+    if (game->gpu != NULL)
+        gol_gpu_hostchanged(game->gpu);
+    // the tile of the cell (and so its neighbors) has to be ticked again
+    if (game->tile_changed != NULL)
+        game->tile_changed[((size_t)y / GOL_TILE) * game->tiles_x + (size_t)x / GOL_TILE] = true;
+    return GOL_ERR_OK;
+}
+
+// Sets 'count' cells of row y starting at column x at once, with a memset on byte boards and whole words at a time on
+// packed boards
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (not all of the cells are on the board), GOL_ERR_IO,
+// GOL_ERR_OK
+gol_err gol_setrun(struct gameoflife *game, gol_pos x, gol_pos y, gol_pos count, bool alive) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || count < 0 || count > game->cols - x || y < 0 || y >= game->rows) return GOL_ERR_RANGE;
+    if (count == 0) return GOL_ERR_OK;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    if (game->storage == GOL_STORAGE_PACKED) {
+        uint64_t *row = gol_packedrow(game, game->packed, y);
+        size_t first = (size_t)x / 64, last = (size_t)(x + count - 1) / 64;
+        for (size_t w = first; w <= last; w++) {
+            // the bits of this word within the run
+            uint64_t mask = ~(uint64_t)0;
+            if (w == first) mask &= ~(uint64_t)0 << (x % 64);
+            if (w == last && (x + count) % 64) mask &= ((uint64_t)1 << ((x + count) % 64)) - 1;
+            row[w] = alive ? (row[w] | mask) : (row[w] & ~mask);
+        }
+    } else {
+        memset(game->board + gol_2dto1d(game, x, y), alive, (size_t)count * sizeof(bool));
+    }
+    game->population_known = false;
+    game->hash_known = false;
+    game->history_count = 0;
+    if (game->gpu != NULL)
+        gol_gpu_hostchanged(game->gpu);
+    // the tiles of the run have to be ticked again
+    if (game->tile_changed != NULL) {
+        for (size_t tx = (size_t)x / GOL_TILE; tx <= (size_t)(x + count - 1) / GOL_TILE; tx++)
+            game->tile_changed[((size_t)y / GOL_TILE) * game->tiles_x + tx] = true;
+    }
+    return GOL_ERR_OK;
+}
+
+// Marks every tile of a game with tile tracking as changed, so the next tick visits the whole board, and forgets the
+// population, hash and history of the board. This must be called after writing to the board without gol_setcell or
+// gol_setrun, and makes the board in host memory the one a gpu ticks next
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_markdirty(struct gameoflife *game) {
+    game->population_known = false;
+    game->hash_known = false;
+    game->history_count = 0;
+    if (game->gpu != NULL)
+        gol_gpu_hostchanged(game->gpu);
+    if (game->tile_changed != NULL)
+        memset(game->tile_changed, true, game->tiles_x * game->tiles_y * sizeof(bool));
+    return GOL_ERR_OK;
+}
+
+// Kills every cell of the board
 // Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
-gol_err gol_populate(struct gameoflife *game) {
-    if (game->board == NULL) return GOL_ERR_INIT;
+gol_err gol_clear(struct gameoflife *game) {
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+
+    if (game->storage == GOL_STORAGE_PACKED)
+        memset(game->packed, 0, (size_t)game->rows * game->words * sizeof(uint64_t));
+    else
+        memset(game->board, 0, (size_t)game->rows * (size_t)game->cols * sizeof(bool));
+    gol_markdirty(game);
+    game->population = 0;
+    game->population_known = true;
+    game->hash = 0;
+    game->hash_known = true;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Counts the live cells of the w x h rectangle starting at column x, row y, which must be on the board
+// The words of packed rows are counted whole by the kernel, with the partial words at either end masked. byte boards
+// count each row of the rectangle with the kernel, or the whole rectangle at once if it spans full rows
+static uint64_t gol_countregion(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h) {
+    const struct gol_kernel *kernel = gol_kernel();
+    uint64_t population = 0;
+    if (w == 0 || h == 0) return 0;
+
+    if (game->storage == GOL_STORAGE_BYTES) {
+        if (x == 0 && w == game->cols)
+            return kernel->bytespopulation(game->board + gol_2dto1d(game, 0, y), (size_t)w * (size_t)h);
+        for (gol_pos row = y; row < y + h; row++)
+            population += kernel->bytespopulation(game->board + gol_2dto1d(game, x, row), (size_t)w);
+        return population;
+    }
+
+    // padding bits past the last column are always dead, so full rows are counted as one run of words
+    if (x == 0 && w == game->cols)
+        return kernel->packedpopulation(gol_packedrow(game, game->packed, y), (size_t)h * game->words);
+    size_t first = (size_t)x / 64, last = (size_t)(x + w - 1) / 64;
+    uint64_t first_mask = ~(uint64_t)0 << (x % 64);
+    uint64_t last_mask = (x + w) % 64 ? ((uint64_t)1 << ((x + w) % 64)) - 1 : ~(uint64_t)0;
+    for (gol_pos row = y; row < y + h; row++) {
+        const uint64_t *words = gol_packedrow(game, game->packed, row);
+        if (first == last) {
+            population += gol_popcount64(words[first] & first_mask & last_mask);
+            continue;
+        }
+        population += gol_popcount64(words[first] & first_mask) + gol_popcount64(words[last] & last_mask);
+        population += kernel->packedpopulation(words + first + 1, last - first - 1);
+    }
+    return population;
+}
+
+// Provides the number of live cells on the board, counted with the popcount kernel unless it's already known
+// (see gameoflife.population_known), which it is after every tick with gol_options.stats
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_population(const struct gameoflife *game, uint64_t *population) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (!game->population_known && (error = gol_sync(game)) != GOL_ERR_OK) return error;
+    *population = game->population_known ? game->population : gol_countregion(game, 0, 0, game->cols, game->rows);
+    return GOL_ERR_OK;
+}
+
+// Provides the number of live cells in the w x h rectangle of the board starting at column x, row y
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (not all of the rectangle is on the board), GOL_ERR_IO,
+// GOL_ERR_OK
+gol_err gol_region_population(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h,
+                              uint64_t *population) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || y < 0 || w < 0 || h < 0 || w > game->cols - x || h > game->rows - y) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+    *population = gol_countregion(game, x, y, w, h);
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Finds the first and last live cell of row y, returns false if the row is empty
+static bool gol_rowbounds(const struct gameoflife *game, gol_pos y, gol_pos *first, gol_pos *last) {
+    if (game->storage == GOL_STORAGE_PACKED) {
+        const uint64_t *words = gol_packedrow(game, game->packed, y);
+        size_t w0 = 0, w1 = game->words;
+        while (w0 < w1 && words[w0] == 0) w0++;
+        if (w0 == w1) return false;
+        while (words[w1 - 1] == 0) w1--;
+        *first = (gol_pos)(w0 * 64 + gol_lowbit64(words[w0]));
+        *last = (gol_pos)((w1 - 1) * 64 + gol_highbit64(words[w1 - 1]));
+        return true;
+    }
+    const bool *cells = game->board + gol_2dto1d(game, 0, y);
+    const bool *alive = (const bool *) memchr(cells, true, (size_t)game->cols * sizeof(bool));
+    if (alive == NULL) return false;
+    gol_pos x = game->cols - 1;
+    while (!cells[x]) x--;
+    *first = (gol_pos)(alive - cells);
+    *last = x;
+    return true;
+}
 
-    // loop through all possible coordinates
+// Provides the smallest rectangle holding every live cell of the board, as its first column x, first row y, and its
+// width w and height h. An empty board gives 0 for all four
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_bbox(const struct gameoflife *game, gol_pos *x, gol_pos *y, gol_pos *w, gol_pos *h) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+    gol_pos top = -1, bottom = -1, left = game->cols, right = -1;
+    for (gol_pos row = 0; row < game->rows; row++) {
+        gol_pos first, last;
+        if (!gol_rowbounds(game, row, &first, &last)) continue;
+        if (top < 0) top = row;
+        bottom = row;
+        if (first < left) left = first;
+        if (last > right) right = last;
+    }
+    if (top < 0) {
+        *x = *y = *w = *h = 0;
+        return GOL_ERR_OK;
+    }
+    *x = left;
+    *y = top;
+    *w = right - left + 1;
+    *h = bottom - top + 1;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Hashes the whole board, every group of 64 cells (see gol_hashword)
+static uint64_t gol_scanhash(const struct gameoflife *game) {
+    uint64_t hash = 0;
     for (gol_pos y = 0; y < game->rows; y++) {
-        for (gol_pos x = 0; x < game->cols; x++) {
-            // set the coordinates randomly to either TRUE or FALSE
-            unsigned int pos = gol_2dto1d(game, x, y);
-            game->board[pos] = (bool) (rand() % 2); // NOLINT(cert-msc50-cpp)
+        for (size_t w = 0; w < game->words; w++) {
+            uint64_t cells;
+            if (game->storage == GOL_STORAGE_PACKED) {
+                cells = gol_packedrow(game, game->packed, y)[w];
+            } else {
+                size_t count = (size_t)game->cols - w * 64 < 64 ? (size_t)game->cols - w * 64 : 64;
+                cells = gol_packcells(game->board + gol_2dto1d(game, (gol_pos)(w * 64), y), count);
+            }
+            hash ^= gol_hashword(game, y, w, cells);
         }
     }
+    return hash;
+}
+
+// Provides the hash of the board, the xor of the hashes of every group of 64 cells, so the groups that change are
+// all a tick has to hash again. Hashed from scratch unless it's already known (see gameoflife.hash_known), which it is after
+// every tick of a game with a history
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_hash(const struct gameoflife *game, uint64_t *hash) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (!game->hash_known && (error = gol_sync(game)) != GOL_ERR_OK) return error;
+    *hash = game->hash_known ? game->hash : gol_scanhash(game);
     return GOL_ERR_OK;
 }
 
+// Looks for the current generation in the history of the board, newest first, by its hash. A match means the board
+// repeats every 'period' generations from generation 'since' on (1 for a still life), or at least every multiple of
+// the true period if the history skipped generations (see gol_tick_n). 'period' is 0 if nothing in the history matches
+// Possible errors (return value): GOL_ERR_INIT (the game has no history), GOL_ERR_OK
+gol_err gol_cycle(const struct gameoflife *game, uint64_t *period, uint64_t *since) {
+    if (game->history == NULL) return GOL_ERR_INIT;
+    *period = 0;
+    *since = 0;
+    // the newest entry is the current generation, if it has been recorded yet
+    size_t newest = (game->history_next + game->history_size - 1) % game->history_size;
+    if (game->history_count == 0 || game->history[newest].generation != game->generation) return GOL_ERR_OK;
+    for (size_t i = 1; i < game->history_count; i++) {
+        const struct gol_history *entry = &game->history[(newest + game->history_size - i) % game->history_size];
+        if (entry->hash != game->history[newest].hash) continue;
+        *period = game->generation - entry->generation;
+        *since = entry->generation;
+        break;
+    }
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Makes sure the hash of the board is known and puts it into the history as the current generation's
+static void gol_record(struct gameoflife *game) {
+    if (!game->hash_known) {
+        game->hash = gol_scanhash(game);
+        game->hash_known = true;
+    }
+    size_t newest = (game->history_next + game->history_size - 1) % game->history_size;
+    if (game->history_count > 0 && game->history[newest].generation == game->generation) return;
+    game->history[game->history_next].hash = game->hash;
+    game->history[game->history_next].generation = game->generation;
+    game->history_next = (game->history_next + 1) % game->history_size;
+    if (game->history_count < game->history_size) game->history_count++;
+}
+
+// the work of gol_populate_seeded, shared by all workers
+struct gol_fill {
+    struct gameoflife *game;
+    uint64_t seed;
+    // the density in units of 1 / 2^GOL_FILL_BITS, and the lowest bit set in it
+    uint32_t threshold;
+    unsigned int lowest;
+};
+
+// PRIVATE
+// Fills a band of rows of the board, every worker gets an equal share of the rows
+// The cells of word w of row y always come from the same random words, whatever band they fall in
+static void gol_fillband(void *arg, unsigned int worker, unsigned int workers) {
+    const struct gol_fill *fill = (const struct gol_fill *) arg;
+    struct gameoflife *game = fill->game;
+    const size_t words = ((size_t)game->cols + 63) / 64;
+    gol_pos y0 = game->rows * worker / workers, y1 = game->rows * (worker + 1) / workers;
+
+    for (gol_pos y = y0; y < y1; y++) {
+        for (size_t w = 0; w < words; w++) {
+            uint64_t cells = fill->threshold >> GOL_FILL_BITS
+                             ? ~(uint64_t)0
+                             : gol_fillword(fill->seed, fill->threshold, fill->lowest, (size_t)y * words + w);
+            if (game->storage == GOL_STORAGE_PACKED) {
+                // bits past the last column must stay dead
+                if (w == words - 1 && game->cols % 64) cells &= ((uint64_t)1 << (game->cols % 64)) - 1;
+                gol_packedrow(game, game->packed, y)[w] = cells;
+                continue;
+            }
+            bool *row = game->board + (size_t)y * (size_t)game->cols + w * 64;
+            size_t count = w == words - 1 && game->cols % 64 ? (size_t)game->cols % 64 : 64;
+            for (size_t x = 0; x < count; x++, cells >>= 1)
+                row[x] = cells & 1;
+        }
+    }
+}
+
+// Populates the board with random cells, each alive with a probability of 'density' (from 0 to 1, rounded to a
+// multiple of 1 / 2^GOL_FILL_BITS), drawn from a counter-based generator seeded with 'seed' instead of rand()
+// The same seed and density always give the same board, regardless of the storage or the number of threads, which
+// fill the board in bands of rows. 64 cells are drawn at once, a density of 0.5 takes a single random word for them
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (density not within [0, 1]), GOL_ERR_OK
+gol_err gol_populate_seeded(struct gameoflife *game, uint64_t seed, double density) {
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    // also catches NaN
+    if (!(density >= 0.0 && density <= 1.0)) return GOL_ERR_RANGE;
+
+    struct gol_fill fill = {game, seed, (uint32_t) (density * (double) (1u << GOL_FILL_BITS) + 0.5), 0};
+    while (fill.lowest < GOL_FILL_BITS && !((fill.threshold >> fill.lowest) & 1))
+        fill.lowest++;
+    if (game->pool != NULL)
+        gol_pool_run(game->pool, gol_fillband, &fill);
+    else
+        gol_fillband(&fill, 0, 1);
+
+    // every cell was written without gol_setcell
+    return gol_markdirty(game);
+}
+
+// Populates the gameoflife struct board with random values (either 1 or 0) at each position
+// The seed is drawn from rand(), so srand still decides the board, see gol_populate_seeded for reproducible boards
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_populate(struct gameoflife *game) {
+    uint64_t seed = (uint64_t)rand() << 32 ^ (uint64_t)rand(); // NOLINT(cert-msc50-cpp)
+    return gol_populate_seeded(game, seed, 0.5);
+}
+
+// PRIVATE
+// Calculates word w of a packed row like the row kernels do, but shifting in the halo cells west of the first column
+// and east of the last column, 'west' and 'east' holding them for the rows above, at and below
+static uint64_t gol_packededge(const struct gameoflife *game, const uint64_t *rows[3], const bool west[3],
+                               const bool east[3], size_t w) {
+    const size_t words = game->words;
+    uint64_t lanes[3][3];
+    for (int i = 0; i < 3; i++) {
+        const uint64_t *row = rows[i];
+        uint64_t west_in = w > 0 ? row[w - 1] >> 63 : (uint64_t)west[i];
+        uint64_t east_in = w + 1 < words ? row[w + 1] << 63 : 0;
+        lanes[i][0] = (row[w] << 1) | west_in;
+        lanes[i][1] = row[w];
+        lanes[i][2] = (row[w] >> 1) | east_in;
+        // the padding bits past the last column are dead, so the east halo cell lines up with the last column
+        if (w == words - 1) lanes[i][2] |= (uint64_t)east[i] << ((game->cols - 1) % 64);
+    }
+    if (game->rule.conway)
+        return gol_wordnext(lanes[0][0], lanes[0][1], lanes[0][2],
+                            lanes[1][0], lanes[1][1], lanes[1][2],
+                            lanes[2][0], lanes[2][1], lanes[2][2]);
+    return gol_wordrule(&game->rule, lanes[0][0], lanes[0][1], lanes[0][2],
+                        lanes[1][0], lanes[1][1], lanes[1][2],
+                        lanes[2][0], lanes[2][1], lanes[2][2]);
+}
+
+// PRIVATE
+// Ticks words [w0, w1) of row y of a packed board, writing the next generation into the packed back buffer
+// The rows above and below the board are their halo rows: the zeroed row allocated after the buffer for dead edges,
+// or a row of the board itself. Columns off the board shift in dead cells in the row kernel, with the halo columns
+// patched into the first and last word afterwards for the other boundary modes
+static void gol_tickpacked(struct gameoflife *game, const struct gol_kernel *kernel, gol_pos y, size_t w0, size_t w1) {
+    const size_t words = game->words;
+    const gol_pos ry[3] = {gol_wrap(game->boundary, y - 1, game->rows), y, gol_wrap(game->boundary, y + 1, game->rows)};
+    const uint64_t *rows[3];
+    for (int i = 0; i < 3; i++)
+        rows[i] = gol_packedrow(game, game->packed, ry[i] >= 0 ? ry[i] : game->rows);
+    uint64_t *out = gol_packedrow(game, game->packed_back, y);
+    if (w0 >= w1) return;
+
+    if (game->rule.conway)
+        kernel->packedrow(rows[0], rows[1], rows[2], out, w0, w1, words);
+    else
+        kernel->packedrule(&game->rule, rows[0], rows[1], rows[2], out, w0, w1, words);
+    if (game->boundary != GOL_BOUNDARY_DEAD) {
+        bool west[3], east[3];
+        for (int i = 0; i < 3; i++) {
+            west[i] = ry[i] >= 0 && game->halo_west[ry[i]];
+            east[i] = ry[i] >= 0 && game->halo_east[ry[i]];
+        }
+        if (w0 == 0) out[0] = gol_packededge(game, rows, west, east, 0);
+        if (w1 == words && words > 1) out[words - 1] = gol_packededge(game, rows, west, east, words - 1);
+    }
+    // bits of the last word of each row that are past the last column must stay dead
+    if (w1 == words && game->cols % 64)
+        out[words - 1] &= ((uint64_t)1 << (game->cols % 64)) - 1;
+}
+
+// PRIVATE
+// Ticks columns [x0, x1) of row y of a byte board, writing the next generation into the back buffer
+// Cells on the outer ring of the board have neighbors off the board, so are counted with bounds checks. Every other
+// cell sums its 3x3 window without any bounds checks in the row kernel picked for this cpu (see gol_kernelname)
+static void gol_tickbytes(struct gameoflife *game, const struct gol_kernel *kernel, gol_pos y, gol_pos x0, gol_pos x1) {
+    const gol_pos rows = game->rows, cols = game->cols;
+    const size_t row = (size_t)y * (size_t)cols;
+    const bool *board = game->board;
+    bool *back = game->back;
+    if (x0 >= x1) return;
+
+    // the first and last rows are done in full with bounds checks
+    if (y == 0 || y == rows - 1 || cols < 3) {
+        for (gol_pos x = x0; x < x1; x++)
+            back[row + x] = game->rule.next[board[row + x]][gol_countlive(game, x, y)];
+        return;
+    }
+
+    // every other row only has its first and last cell on the ring
+    if (x0 == 0) {
+        back[row] = game->rule.next[board[row]][gol_countlive(game, 0, y)];
+        x0 = 1;
+    }
+    gol_pos end = x1 == cols ? cols - 1 : x1;
+    if (end > x0 && game->rule.conway)
+        kernel->bytesrow(board + row - cols + x0, board + row + x0, board + row + cols + x0, back + row + x0,
+                         (size_t)(end - x0));
+    else if (end > x0)
+        kernel->bytesrule(&game->rule, board + row - cols + x0, board + row + x0, board + row + cols + x0,
+                          back + row + x0, (size_t)(end - x0));
+    if (x1 == cols)
+        back[row + cols - 1] = game->rule.next[board[row + cols - 1]][gol_countlive(game, cols - 1, y)];
+}
+
+// PRIVATE
+// Ticks one tile of a board with tile tracking, and reports whether any of its cells changed
+static bool gol_ticktile(struct gameoflife *game, const struct gol_kernel *kernel, size_t tx, size_t ty) {
+    gol_pos y0 = (gol_pos)(ty * GOL_TILE), y1 = y0 + GOL_TILE < game->rows ? y0 + GOL_TILE : game->rows;
+    bool changed = false;
+
+    if (game->storage == GOL_STORAGE_PACKED) {
+        // a tile is exactly one word wide
+        for (gol_pos y = y0; y < y1; y++) {
+            gol_tickpacked(game, kernel, y, tx, tx + 1);
+            changed |= gol_packedrow(game, game->packed_back, y)[tx] != gol_packedrow(game, game->packed, y)[tx];
+        }
+        return changed;
+    }
+
+    gol_pos x0 = (gol_pos)(tx * GOL_TILE), x1 = x0 + GOL_TILE < game->cols ? x0 + GOL_TILE : game->cols;
+    for (gol_pos y = y0; y < y1; y++) {
+        gol_tickbytes(game, kernel, y, x0, x1);
+        size_t pos = gol_2dto1d(game, x0, y);
+        changed |= memcmp(game->back + pos, game->board + pos, (size_t)(x1 - x0) * sizeof(bool)) != 0;
+    }
+    return changed;
+}
+
+#if GOL_STATS
+// PRIVATE
+// Adds the cells of columns [x0, x1) of row y to the worker's counts, comparing the board to the next generation in the
+// back buffer. called right after the row is ticked, while both rows are still in cache
+static void gol_countrow(const struct gameoflife *game, const struct gol_kernel *kernel, struct gol_tickcount *count,
+                         gol_pos y, gol_pos x0, gol_pos x1) {
+    // live cells before and after, and the cells that changed: births - deaths is the change in population
+    uint64_t counts[3] = {0, 0, 0};
+    if (game->storage == GOL_STORAGE_PACKED) {
+        size_t w0 = (size_t)x0 / 64, w1 = ((size_t)x1 + 63) / 64;
+        kernel->packedcount(gol_packedrow(game, game->packed, y) + w0, gol_packedrow(game, game->packed_back, y) + w0,
+                            w1 - w0, counts);
+    } else {
+        size_t pos = gol_2dto1d(game, x0, y);
+        kernel->bytescount(game->board + pos, game->back + pos, (size_t)(x1 - x0), counts);
+    }
+    count->population += counts[1];
+    count->births += (counts[2] + counts[1] - counts[0]) / 2;
+    count->deaths += (counts[2] + counts[0] - counts[1]) / 2;
+}
+#endif
+
 // PRIVATE
-// Calculates the next condition of the cell (alive or dead) based on whether the cell is alive and the number of live neighbors it has
-// Returns: The next condition of the cell
-static bool gol_cellnext(bool is_alive, int live_neighbors) {
-    // condition for this cell to survive if it's alive
-    bool survive = is_alive && live_neighbors >= 2 && live_neighbors <= 3;
-    // condition for this cell to become alive through reproduction
-    bool reproduce = !is_alive && live_neighbors == 3;
+// Adds the change in hash of the groups of 64 cells of columns [x0, x1) of row y to the worker's hash, right after the
+// row is ticked like gol_countrow. x0 must be a multiple of 64, then the groups are the row's words (or tiles)
+static void gol_hashrow(const struct gameoflife *game, struct gol_tickcount *count, gol_pos y, gol_pos x0, gol_pos x1) {
+    uint64_t hash = 0;
+    for (size_t w = (size_t)x0 / 64; w < ((size_t)x1 + 63) / 64; w++) {
+        uint64_t before, after;
+        if (game->storage == GOL_STORAGE_PACKED) {
+            before = gol_packedrow(game, game->packed, y)[w];
+            after = gol_packedrow(game, game->packed_back, y)[w];
+        } else {
+            size_t pos = gol_2dto1d(game, (gol_pos)(w * 64), y);
+            size_t cells = (size_t)game->cols - w * 64 < 64 ? (size_t)game->cols - w * 64 : 64;
+            if (memcmp(game->board + pos, game->back + pos, cells * sizeof(bool)) == 0) continue;
+            before = gol_packcells(game->board + pos, cells);
+            after = gol_packcells(game->back + pos, cells);
+        }
+        if (before != after) hash ^= gol_hashword(game, y, w, before) ^ gol_hashword(game, y, w, after);
+    }
+    count->hash ^= hash;
+}
 
-    // return whether it is still alive or has reproduced
-    // all other conditions means that the cell dies
-    return survive || reproduce;
+// PRIVATE
+// Provides the fixed size kernel of 'kernel' the board ticks with, if it's a packed board of one of their sizes and
+// boundaries under conway's rule without tile tracking (see gol_fixedkernel)
+static const struct gol_fixed *gol_tickfixed(const struct gameoflife *game, const struct gol_kernel *kernel) {
+    if (game->storage != GOL_STORAGE_PACKED || !game->rule.conway || game->tile_changed != NULL) return NULL;
+    return gol_fixedkernel(kernel, game->rows, game->cols, game->boundary);
+}
+
+// PRIVATE
+// Ticks the band of rows belonging to one worker, every worker gets a contiguous band of about rows / workers rows
+// With tile tracking the bands are made of whole rows of tiles, and only the active tiles of the band are ticked
+static void gol_tickband(void *arg, unsigned int worker, unsigned int workers) {
+    struct gameoflife *game = (struct gameoflife *) arg;
+    const struct gol_kernel *kernel = gol_kernel();
+    struct gol_tickcount *count = game->tickcounts != NULL ? &game->tickcounts[worker] : NULL;
+
+    if (game->tile_changed != NULL) {
+        size_t ty0 = game->tiles_y * worker / workers, ty1 = game->tiles_y * (worker + 1) / workers;
+        for (size_t ty = ty0; ty < ty1; ty++) {
+            gol_pos y0 = (gol_pos)(ty * GOL_TILE), y1 = y0 + GOL_TILE < game->rows ? y0 + GOL_TILE : game->rows;
+            for (size_t tx = 0; tx < game->tiles_x; tx++) {
+                size_t t = ty * game->tiles_x + tx;
+                game->tile_changed[t] = game->tile_active[t] && gol_ticktile(game, kernel, tx, ty);
+                // only the cells of changed tiles flip
+                gol_pos x0 = (gol_pos)(tx * GOL_TILE), x1 = x0 + GOL_TILE < game->cols ? x0 + GOL_TILE : game->cols;
+                for (gol_pos y = y0; y < y1 && game->tile_changed[t] && game->history != NULL; y++)
+                    gol_hashrow(game, count, y, x0, x1);
+            }
+#if GOL_STATS
+            // stable tiles still hold live cells, their back buffer is already up to date so they're counted alike
+            for (gol_pos y = y0; y < y1 && game->counting; y++)
+                gol_countrow(game, kernel, count, y, 0, game->cols);
+#endif
+        }
+        return;
+    }
+
+    gol_pos y0, y1;
+    gol_bandrows(game, worker, workers, &y0, &y1);
+    const struct gol_fixed *fixed = gol_tickfixed(game, kernel);
+    if (fixed != NULL) {
+        // the whole band at once, then counted and hashed while it's still in cache
+        fixed->band(game->packed, game->packed_back, y0, y1);
+        for (gol_pos y = y0; y < y1; y++) {
+#if GOL_STATS
+            if (game->counting) gol_countrow(game, kernel, count, y, 0, game->cols);
+#endif
+            if (game->history != NULL) gol_hashrow(game, count, y, 0, game->cols);
+        }
+        return;
+    }
+    for (gol_pos y = y0; y < y1; y++) {
+        if (game->storage == GOL_STORAGE_PACKED)
+            gol_tickpacked(game, kernel, y, 0, game->words);
+        else
+            gol_tickbytes(game, kernel, y, 0, game->cols);
+#if GOL_STATS
+        if (game->counting) gol_countrow(game, kernel, count, y, 0, game->cols);
+#endif
+        if (game->history != NULL) gol_hashrow(game, count, y, 0, game->cols);
+    }
+}
+
+// PRIVATE
+// Reads a cell of the board of either storage, without any checks
+static inline bool gol_cellat(const struct gameoflife *game, gol_pos x, gol_pos y) {
+    if (game->storage == GOL_STORAGE_PACKED)
+        return (gol_packedrow(game, game->packed, y)[x / 64] >> (x % 64)) & 1;
+    return game->board[gol_2dto1d(game, x, y)];
+}
+
+// PRIVATE
+// Refreshes the halo (the ring of ghost cells around the board) from the cells it mirrors under the boundary mode
+// This happens once per tick, so the row kernels never have to care about the boundary mode
+static void gol_refreshhalo(struct gameoflife *game) {
+    const gol_pos rows = game->rows, cols = game->cols;
+    const gol_boundary boundary = game->boundary;
+    if (rows == 0 || cols == 0) return;
+
+    gol_pos west = gol_wrap(boundary, -1, cols), east = gol_wrap(boundary, cols, cols);
+    for (gol_pos y = 0; y < rows; y++) {
+        game->halo_west[y] = west >= 0 && gol_cellat(game, west, y);
+        game->halo_east[y] = east >= 0 && gol_cellat(game, east, y);
+    }
+    if (game->storage == GOL_STORAGE_PACKED) return;
+
+    gol_pos top = gol_wrap(boundary, -1, rows), bottom = gol_wrap(boundary, rows, rows);
+    for (gol_pos x = -1; x <= cols; x++) {
+        gol_pos hx = gol_wrap(boundary, x, cols);
+        game->halo_top[x + 1] = hx >= 0 && top >= 0 && gol_cellat(game, hx, top);
+        game->halo_bottom[x + 1] = hx >= 0 && bottom >= 0 && gol_cellat(game, hx, bottom);
+    }
+}
+
+// PRIVATE
+// Marks the tiles that have to be ticked this generation: every tile that changed last generation, and their neighbors
+// A tile whose whole 3x3 neighborhood of tiles didn't change is stable, and the back buffer already holds its next generation
+// Returns: The number of active tiles
+static size_t gol_marktiles(struct gameoflife *game) {
+    const size_t tiles_x = game->tiles_x, tiles_y = game->tiles_y;
+    size_t active = 0;
+
+    // on a torus the tiles on opposite edges are neighbors too
+    const gol_boundary boundary = game->boundary == GOL_BOUNDARY_TORUS ? GOL_BOUNDARY_TORUS : GOL_BOUNDARY_DEAD;
+
+    for (size_t ty = 0; ty < tiles_y; ty++) {
+        for (size_t tx = 0; tx < tiles_x; tx++) {
+            bool is_active = false;
+            for (gol_pos dy = -1; dy <= 1; dy++) {
+                gol_pos ny = gol_wrap(boundary, (gol_pos)ty + dy, (gol_pos)tiles_y);
+                for (gol_pos dx = -1; dx <= 1 && ny >= 0; dx++) {
+                    gol_pos nx = gol_wrap(boundary, (gol_pos)tx + dx, (gol_pos)tiles_x);
+                    if (nx >= 0) is_active |= game->tile_changed[(size_t)ny * tiles_x + (size_t)nx];
+                }
+            }
+            game->tile_active[ty * tiles_x + tx] = is_active;
+            active += is_active;
+        }
+    }
+    return active;
+}
+
+// PRIVATE
+// Swaps the board with its back buffer, once the back buffer holds the next generation
+static void gol_swapboards(struct gameoflife *game) {
+    if (game->storage == GOL_STORAGE_PACKED) {
+        uint64_t *next = game->packed_back;
+        game->packed_back = game->packed;
+        game->packed = next;
+    } else {
+        bool *next = game->back;
+        game->back = game->board;
+        game->board = next;
+    }
+}
+
+#if GOL_STATS
+// PRIVATE
+// Reads a monotonic clock, in nanoseconds
+static uint64_t gol_nanotime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+// PRIVATE
+// Provides the bytes of one row of the board
+static size_t gol_rowbytes(const struct gameoflife *game) {
+    if (game->storage == GOL_STORAGE_PACKED) return game->words * sizeof(uint64_t);
+    return (size_t)game->cols * sizeof(bool);
+}
+
+// PRIVATE
+// Fills in the statistics of a tick that started at 'start' (see gol_nanotime), summing up the counts of the workers
+// if the tick counted its cells, and clears the counts for the next tick
+static void gol_endstats(struct gameoflife *game, uint64_t start, uint64_t generations, uint64_t bytes, bool counted) {
+    const unsigned int workers = game->pool != NULL ? gol_pool_size(game->pool) : 1;
+    struct gol_stats *stats = &game->stats;
+    stats->generation = game->generation;
+    stats->generations = generations;
+    stats->counted = counted;
+    stats->population = stats->births = stats->deaths = 0;
+    for (unsigned int i = 0; i < workers && counted; i++) {
+        stats->population += game->tickcounts[i].population;
+        stats->births += game->tickcounts[i].births;
+        stats->deaths += game->tickcounts[i].deaths;
+    }
+    for (unsigned int i = 0; i < workers; i++)
+        game->tickcounts[i].population = game->tickcounts[i].births = game->tickcounts[i].deaths = 0;
+    stats->nanoseconds = gol_nanotime() - start;
+    stats->bytes = bytes;
+}
+#endif
+
+// PRIVATE
+// Ticks a board on the gpu n generations, leaving the board in host memory behind until it's read (see gol_sync)
+// Possible errors (return value): GOL_ERR_IO (the gpu failed), GOL_ERR_OK
+static gol_err gol_tickgpu(struct gameoflife *game, unsigned long n) {
+    gol_err error;
+#if GOL_STATS
+    const uint64_t start = game->counting ? gol_nanotime() : 0;
+#endif
+    if ((error = gol_gpu_tick(game->gpu, game, n)) != GOL_ERR_OK) return error;
+    game->generation += n;
+    game->population_known = false;
+    game->hash_known = false;
+#if GOL_STATS
+    // the cells never leave the device, so they aren't counted, and the bytes are those of the device memory
+    if (game->counting) gol_endstats(game, start, n, 2 * (uint64_t)n * game->rows * gol_rowbytes(game), false);
+#endif
+    return GOL_ERR_OK;
 }
 
 // Ticks the progress of the gameoflife board forward, calculating the next state of each cell
-// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_INIT, GOL_ERR_OK
+// The next generation is written into the back buffer, which is then swapped with the board, so no memory is allocated
+// With more than one thread configured, the rows are split into bands that are ticked by the game's worker pool
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO (the gpu failed), GOL_ERR_OK
 gol_err gol_tick(struct gameoflife *game) {
-    // stores the GOL error of various different API calls
+    if (game->storage == GOL_STORAGE_PACKED) {
+        if (game->packed == NULL || game->packed_back == NULL) return GOL_ERR_INIT;
+    } else {
+        if (game->board == NULL || game->back == NULL) return GOL_ERR_INIT;
+    }
+    if (game->gpu != NULL)
+        return gol_tickgpu(game, 1);
+#if GOL_STATS
+    const uint64_t start = game->counting ? gol_nanotime() : 0;
+#endif
+    // the changes to the hash are summed up from the current generation's, which has to be known for that
+    if (game->history != NULL)
+        gol_record(game);
+
+    // the fixed size kernels wrap the torus themselves
+    if (game->boundary != GOL_BOUNDARY_DEAD && gol_tickfixed(game, gol_kernel()) == NULL)
+        gol_refreshhalo(game);
+    if (game->tile_changed != NULL)
+        game->active_tiles = gol_marktiles(game);
+
+    // every band only reads the board and writes its own rows of the back buffer, so the bands are independent
+    if (game->pool != NULL)
+        gol_pool_run(game->pool, gol_tickband, game);
+    else
+        gol_tickband(game, 0, 1);
+
+    // the back buffer now holds the next generation, so swap it in
+    gol_swapboards(game);
+    game->generation++;
+    game->population_known = false;
+    if (game->history != NULL) {
+        const unsigned int workers = game->pool != NULL ? gol_pool_size(game->pool) : 1;
+        for (unsigned int i = 0; i < workers; i++) {
+            game->hash ^= game->tickcounts[i].hash;
+            game->tickcounts[i].hash = 0;
+        }
+        gol_record(game);
+    } else {
+        game->hash_known = false;
+    }
+#if GOL_STATS
+    if (game->counting) {
+        // every row is read from the board and written to the back buffer once, or only those of the active tiles
+        uint64_t bytes = 2 * (uint64_t)game->rows * gol_rowbytes(game);
+        if (game->tile_changed != NULL)
+            bytes = 2 * (uint64_t)game->active_tiles * GOL_TILE
+                    * (game->storage == GOL_STORAGE_PACKED ? sizeof(uint64_t) : GOL_TILE * sizeof(bool));
+        gol_endstats(game, start, 1, bytes, true);
+        // the population was counted as the rows were ticked
+        game->population = game->stats.population;
+        game->population_known = true;
+    }
+#endif
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Maps a row or column coordinate any distance off the board back onto it according to the boundary mode, as if the
+// board were repeated (torus) or reflected (mirror) forever in every direction. Used by the temporal blocking of
+// gol_tick_n, which needs up to GOL_TICK_DEPTH rows of context past the edges of a band
+// Returns: The coordinate on the board, or -1 if the cell is dead
+static inline gol_pos gol_extend(gol_boundary boundary, gol_pos v, gol_pos n) {
+    if (v >= 0 && v < n) return v;
+    if (boundary == GOL_BOUNDARY_TORUS) {
+        v %= n;
+        return v < 0 ? v + n : v;
+    }
+    if (boundary == GOL_BOUNDARY_MIRROR) {
+        v %= 2 * n;
+        if (v < 0) v += 2 * n;
+        return v < n ? v : 2 * n - 1 - v;
+    }
+    return -1;
+}
+
+// PRIVATE
+// Number of rows in a band of gol_tick_n, not counting the rows of context above and below it. The band and its
+// context are sized so both scratch buffers of a worker fit in GOL_TICK_CACHE bytes, but the context never makes up
+// more than a third of the rows
+static gol_pos gol_blockrows(const struct gameoflife *game, size_t rowbytes) {
+    gol_pos rows = (gol_pos)(GOL_TICK_CACHE / (2 * rowbytes)) - 2 * GOL_TICK_DEPTH;
+    if (rows < 4 * GOL_TICK_DEPTH) rows = 4 * GOL_TICK_DEPTH;
+    return rows < game->rows ? rows : game->rows;
+}
+
+// PRIVATE
+// Size of a row in the scratch buffers of gol_tick_n: packed rows as they are, byte rows with a ghost cell on each side
+static size_t gol_blockrowbytes(const struct gameoflife *game) {
+    if (game->storage == GOL_STORAGE_PACKED) return game->words * sizeof(uint64_t);
+    return ((size_t)game->cols + 2) * sizeof(bool);
+}
+
+// PRIVATE
+// Sets the ghost cells on either side of a scratch byte row from the row itself, according to the boundary mode
+static inline void gol_blockghosts(const struct gameoflife *game, bool *row) {
+    const gol_pos cols = game->cols;
+    gol_pos west = gol_wrap(game->boundary, -1, cols), east = gol_wrap(game->boundary, cols, cols);
+    row[0] = west >= 0 && row[west + 1];
+    row[cols + 1] = east >= 0 && row[east + 1];
+}
+
+// PRIVATE
+// Computes the next generation of row 'mid' of the packed scratch buffers into 'out'
+// The cells west and east of the row come from the row itself according to the boundary mode, like the halo
+static inline void gol_blockpacked(const struct gameoflife *game, const struct gol_kernel *kernel,
+                                   const uint64_t *rows[3], uint64_t *out) {
+    const size_t words = game->words;
+    if (game->rule.conway)
+        kernel->packedrow(rows[0], rows[1], rows[2], out, 0, words, words);
+    else
+        kernel->packedrule(&game->rule, rows[0], rows[1], rows[2], out, 0, words, words);
+
+    if (game->boundary != GOL_BOUNDARY_DEAD) {
+        gol_pos west = gol_wrap(game->boundary, -1, game->cols), east = gol_wrap(game->boundary, game->cols, game->cols);
+        bool west_in[3], east_in[3];
+        for (int i = 0; i < 3; i++) {
+            west_in[i] = (rows[i][west / 64] >> (west % 64)) & 1;
+            east_in[i] = (rows[i][east / 64] >> (east % 64)) & 1;
+        }
+        out[0] = gol_packededge(game, rows, west_in, east_in, 0);
+        if (words > 1) out[words - 1] = gol_packededge(game, rows, west_in, east_in, words - 1);
+    }
+    if (game->cols % 64)
+        out[words - 1] &= ((uint64_t)1 << (game->cols % 64)) - 1;
+}
+
+// PRIVATE
+// Advances rows [y0, y1) of the board 'depth' generations into the back buffer, without touching main memory in between
+// The band is loaded together with 'depth' rows of context above and below into a scratch buffer, and every generation
+// computed in it is one row shorter at both ends than the one before (a trapezoid), so after 'depth' generations
+// exactly the rows of the band are left. Rows off a board with dead edges stay dead, for the other boundary modes the
+// context is read from the repeated or reflected board, which evolves exactly like the board itself
+static void gol_tickblock(struct gameoflife *game, const struct gol_kernel *kernel, unsigned char *scratch,
+                          gol_pos y0, gol_pos y1, unsigned int depth) {
+    const size_t rowbytes = gol_blockrowbytes(game);
+    const gol_pos height = (y1 - y0) + 2 * (gol_pos)depth;
+    const bool packed = game->storage == GOL_STORAGE_PACKED;
+    unsigned char *src = scratch, *dst = scratch + (size_t)height * rowbytes;
+
+    // load the band and its context
+    for (gol_pos i = 0; i < height; i++) {
+        gol_pos y = gol_extend(game->boundary, y0 - (gol_pos)depth + i, game->rows);
+        unsigned char *row = src + (size_t)i * rowbytes;
+        if (y < 0) {
+            // dead rows stay dead in both buffers
+            memset(row, 0, rowbytes);
+            memset(dst + (size_t)i * rowbytes, 0, rowbytes);
+        } else if (packed) {
+            memcpy(row, gol_packedrow(game, game->packed, y), rowbytes);
+        } else {
+            memcpy(row + 1, game->board + (size_t)y * (size_t)game->cols, (size_t)game->cols * sizeof(bool));
+            gol_blockghosts(game, (bool *) row);
+        }
+    }
+
+    for (unsigned int g = 1; g <= depth; g++) {
+        for (gol_pos i = (gol_pos)g; i < height - (gol_pos)g; i++) {
+            if (gol_extend(game->boundary, y0 - (gol_pos)depth + i, game->rows) < 0) continue;
+
+            const unsigned char *up = src + (size_t)(i - 1) * rowbytes;
+            unsigned char *out = dst + (size_t)i * rowbytes;
+            if (packed) {
+                const uint64_t *rows[3] = {(const uint64_t *) up, (const uint64_t *) (up + rowbytes),
+                                           (const uint64_t *) (up + 2 * rowbytes)};
+                gol_blockpacked(game, kernel, rows, (uint64_t *) out);
+            } else {
+                const bool *rows[3] = {(const bool *) up + 1, (const bool *) (up + rowbytes) + 1,
+                                       (const bool *) (up + 2 * rowbytes) + 1};
+                if (game->rule.conway)
+                    kernel->bytesrow(rows[0], rows[1], rows[2], (bool *) out + 1, (size_t)game->cols);
+                else
+                    kernel->bytesrule(&game->rule, rows[0], rows[1], rows[2], (bool *) out + 1, (size_t)game->cols);
+                gol_blockghosts(game, (bool *) out);
+            }
+        }
+        unsigned char *swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    // what's left in the middle is the band, 'depth' generations later
+    for (gol_pos y = y0; y < y1; y++) {
+        const unsigned char *row = src + (size_t)(y - y0 + (gol_pos)depth) * rowbytes;
+        if (packed)
+            memcpy(gol_packedrow(game, game->packed_back, y), row, rowbytes);
+        else
+            memcpy(game->back + (size_t)y * (size_t)game->cols, row + 1, (size_t)game->cols * sizeof(bool));
+    }
+}
+
+// the work of one pass of gol_tick_n, shared by all workers
+struct gol_blockpass {
+    struct gameoflife *game;
+    gol_pos band;
+    unsigned int depth;
+};
+
+// PRIVATE
+// Runs the bands of one pass of gol_tick_n belonging to a worker, every worker takes every workers-th band
+// with its own pair of scratch buffers
+static void gol_tickblocks(void *arg, unsigned int worker, unsigned int workers) {
+    const struct gol_blockpass *pass = (const struct gol_blockpass *) arg;
+    struct gameoflife *game = pass->game;
+    const struct gol_kernel *kernel = gol_kernel();
+    unsigned char *scratch = game->scratch + (game->scratch_size / workers) * worker;
+
+    for (gol_pos y0 = pass->band * (gol_pos)worker; y0 < game->rows; y0 += pass->band * (gol_pos)workers) {
+        gol_pos y1 = y0 + pass->band < game->rows ? y0 + pass->band : game->rows;
+        gol_tickblock(game, kernel, scratch, y0, y1, pass->depth);
+    }
+}
+
+// PRIVATE
+// Grows the scratch buffers of gol_tick_n to the size the board and its threads need, keeping them if they're large
+// enough already
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_tickscratch(struct gameoflife *game) {
+    const size_t rowbytes = gol_blockrowbytes(game);
+    const gol_pos band = gol_blockrows(game, rowbytes);
+    const unsigned int workers = game->pool != NULL ? gol_pool_size(game->pool) : 1;
+    const size_t scratch_size = (size_t)workers * 2 * ((size_t)band + 2 * GOL_TICK_DEPTH) * rowbytes;
+    if (game->scratch_size < scratch_size) {
+        unsigned char *scratch = (unsigned char *) gol_alloc(&game->allocator, scratch_size, 1);
+        if (scratch == NULL) return GOL_ERR_NOMEM;
+        gol_dealloc(&game->allocator, game->scratch);
+        game->scratch = scratch;
+        game->scratch_size = scratch_size;
+    }
+    return GOL_ERR_OK;
+}
+
+// Allocates the scratch buffers gol_tick_n ticks n generations at a time with, so that it doesn't allocate itself
+// They're allocated whenever gol_tick_n could use them, even for the boards of the fixed size kernels, since the
+// kernel can change (see gol_setkernel) after the call
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_OK
+gol_err gol_tick_n_reserve(struct gameoflife *game, unsigned long n) {
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (n <= 1 || game->gpu != NULL || game->rows == 0 || game->cols == 0) return GOL_ERR_OK;
+    return gol_tickscratch(game);
+}
+
+// Ticks the board forward n generations, giving the same board as n calls to gol_tick
+// The board is processed in bands of rows that are advanced up to GOL_TICK_DEPTH generations at a time while they are in
+// cache (temporal blocking), so boards larger than the cache are streamed through memory once every GOL_TICK_DEPTH
+// generations instead of every generation. Bands are spread over the game's threads, and use the same row kernels
+// The scratch buffers are allocated by the first call (or gol_tick_n_reserve) and kept until gol_free
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_IO (the gpu failed), GOL_ERR_OK
+gol_err gol_tick_n(struct gameoflife *game, unsigned long n) {
     gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (n == 0) return GOL_ERR_OK;
+    // the gpu ticks all n generations without coming back to the host
+    if (game->gpu != NULL)
+        return gol_tickgpu(game, n);
+    // not worth blocking for a single generation or an empty board, nor for the boards of the fixed size kernels,
+    // which fit in cache
+    if (n == 1 || game->rows == 0 || game->cols == 0 || gol_tickfixed(game, gol_kernel()) != NULL) {
+        for (unsigned long i = 0; i < n; i++) {
+            if ((error = gol_tick(game)) != GOL_ERR_OK) return error;
+        }
+        return GOL_ERR_OK;
+    }
+#if GOL_STATS
+    const uint64_t start = game->counting ? gol_nanotime() : 0;
+    uint64_t bytes = 0, generations = n;
+#endif
 
-    // create a copy of the entire game
-    // this is to ensure we can't counting or not counting cells that have been permutated this tick
-    struct gameoflife copy;
-    if ((error = gol_copy(&copy, game)) != GOL_ERR_OK) return error;
+    if ((error = gol_tickscratch(game)) != GOL_ERR_OK) return error;
+    const gol_pos band = gol_blockrows(game, gol_blockrowbytes(game));
+    if (game->history != NULL)
+        gol_record(game);
 
-    // loop through each position on the game's board
-    for (gol_pos y = 0; y < game->rows; y++) {
-        for (gol_pos x = 0; x < game->cols; x++) {
-            // find the current value of this cell
-            unsigned int pos = gol_2dto1d(game, x, y);
-            bool is_alive = game->board[pos];
+    while (n > 0) {
+        struct gol_blockpass pass = {game, band, n < GOL_TICK_DEPTH ? (unsigned int) n : GOL_TICK_DEPTH};
+        if (game->pool != NULL)
+            gol_pool_run(game->pool, gol_tickblocks, &pass);
+        else
+            gol_tickblocks(&pass, 0, 1);
+        gol_swapboards(game);
+        game->generation += pass.depth;
+        n -= pass.depth;
+#if GOL_STATS
+        // every band reads its rows and 'depth' rows of context on either side, and writes its rows once per pass
+        uint64_t bands = ((uint64_t)game->rows + (uint64_t)band - 1) / (uint64_t)band;
+        bytes += (2 * (uint64_t)game->rows + 2 * pass.depth * bands) * gol_rowbytes(game);
+#endif
+    }
 
-            // count the number of alive neighbors (out of 8)
-            // use the board copy so that we use a clean board
-            int live_neighbors;
-            if ((error = gol_countlive(&copy, x, y, &live_neighbors)) != GOL_ERR_OK) return error;
+    // the back buffer is several generations behind now, so no tile can be assumed stable
+    if (game->tile_changed != NULL)
+        memset(game->tile_changed, true, game->tiles_x * game->tiles_y * sizeof(bool));
+    game->population_known = false;
+    game->hash_known = false;
+    // the generations in between weren't hashed, but the one the board ends on still is
+    if (game->history != NULL)
+        gol_record(game);
+#if GOL_STATS
+    if (game->counting) gol_endstats(game, start, generations, bytes, false);
+#endif
+    return GOL_ERR_OK;
+}
 
-            // update the cell value with the new next value
-            game->board[pos] = gol_cellnext(is_alive, live_neighbors);
+// PRIVATE
+// Writes the characters of cells [x0, x0 + count) of row y into 'out', reading the row directly for either storage
+static void gol_rendercells(const struct gameoflife *game, gol_pos y, gol_pos x0, size_t count, char *out,
+                            char on_char, char off_char) {
+    if (game->storage == GOL_STORAGE_PACKED) {
+        const uint64_t *row = gol_packedrow(game, game->packed, y);
+        size_t x = (size_t)x0, end = (size_t)x0 + count;
+        while (x < end) {
+            // shift out the cells of one word at a time
+            uint64_t word = row[x / 64] >> (x % 64);
+            size_t stop = (x / 64 + 1) * 64 < end ? (x / 64 + 1) * 64 : end;
+            for (; x < stop; x++, word >>= 1)
+                *out++ = (word & 1) ? on_char : off_char;
         }
+        return;
+    }
+    const bool *row = game->board + (size_t)y * (size_t)game->cols + x0;
+    for (size_t x = 0; x < count; x++)
+        out[x] = row[x] ? on_char : off_char;
+}
+
+// PRIVATE
+// Picks the characters for live and dead cells from 'src', or the defaults if it's NULL
+static void gol_renderchars(const char *src, char *on_char, char *off_char) {
+    *on_char = src != NULL ? src[0] : 'X';
+    *off_char = src != NULL ? src[1] : 'O';
+}
+
+// Renders the w x h rectangle of the board starting at column x, row y as text into a buffer provided by the caller,
+// with each row separated by a new line. Only the cells of the rectangle are read, so a small window of a large board
+// costs as much as the window
+// 'needed' receives the size of the text including its null-terminator. If 'size' is smaller than that nothing is
+// written, so the size can be queried by passing a NULL buffer and a size of 0, and the same buffer reused every frame
+// For custom ALIVE/DEAD character, provide src with atleast 2 characters, otherwise NULL
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (rectangle off the board or buffer too small),
+// GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_render_region(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, char *buf,
+                          size_t size, size_t *needed, const char *src) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || y < 0 || w < 0 || h < 0 || w > game->cols - x || h > game->rows - y) return GOL_ERR_RANGE;
+
+    // every row is followed by a new line, except for the last, which is followed by the null-terminator instead
+    // gol_init_opts made sure this can't overflow for the whole board, so neither can it for a part of it
+    size_t len = ((size_t)w + 1) * (size_t)h + (h == 0);
+    if (needed != NULL) *needed = len;
+    if (buf == NULL || size < len) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    char on_char, off_char;
+    gol_renderchars(src, &on_char, &off_char);
+    size_t i = 0;
+    for (gol_pos row = y; row < y + h; row++) {
+        if (row != y) buf[i++] = '\n';
+        gol_rendercells(game, row, x, (size_t)w, buf + i, on_char, off_char);
+        i += (size_t)w;
     }
+    buf[i] = '\0';
+    return GOL_ERR_OK;
+}
+
+// Renders the whole board as text into a buffer provided by the caller, see gol_render_region
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (buffer too small), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_render(const struct gameoflife *game, char *buf, size_t size, size_t *needed, const char *src) {
+    return gol_render_region(game, 0, 0, game->cols, game->rows, buf, size, needed, src);
+}
+
+// Renders the board as the same text as gol_render, but hands it to 'write' in chunks of at most GOL_RENDER_CHUNK
+// characters (without a null-terminator) instead, so the text of the whole board is never held in memory
+// 'user' is passed on to every call of 'write', which returns false to stop rendering
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_IO (write failed), GOL_ERR_OK
+gol_err gol_render_stream(const struct gameoflife *game, gol_write_fn write, void *user, const char *src) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
 
-    gol_free(&copy);
+    char on_char, off_char;
+    gol_renderchars(src, &on_char, &off_char);
+    char chunk[GOL_RENDER_CHUNK];
+    size_t used = 0;
+    for (gol_pos y = 0; y < game->rows; y++) {
+        if (y != 0) chunk[used++] = '\n';
+        // rows longer than the chunk are split over several writes
+        for (gol_pos x = 0; x < game->cols;) {
+            if (used == GOL_RENDER_CHUNK) {
+                if (!write(user, chunk, used)) return GOL_ERR_IO;
+                used = 0;
+            }
+            size_t count = GOL_RENDER_CHUNK - used;
+            if ((size_t)(game->cols - x) < count) count = (size_t)(game->cols - x);
+            gol_rendercells(game, y, x, count, chunk + used, on_char, off_char);
+            used += count;
+            x += (gol_pos)count;
+        }
+        // always leave room for the next new line
+        if (used == GOL_RENDER_CHUNK) {
+            if (!write(user, chunk, used)) return GOL_ERR_IO;
+            used = 0;
+        }
+    }
+    if (used > 0 && !write(user, chunk, used)) return GOL_ERR_IO;
     return GOL_ERR_OK;
 }
 
+// PRIVATE
+// gol_write_fn writing to the FILE pointer in 'user'
+static bool gol_writefile(void *user, const char *data, size_t size) {
+    return fwrite(data, sizeof(char), size, (FILE *) user) == size;
+}
+
+// Renders the board as the same text as gol_render straight into a file (or stdout), see gol_render_stream
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_IO (write failed), GOL_ERR_OK
+gol_err gol_render_file(const struct gameoflife *game, FILE *file, const char *src) {
+    return gol_render_stream(game, gol_writefile, file, src);
+}
+
 // Converts the gameoflife struct board into a 1d character list, with each row separated by a new line
-// This function does allocate the final dest pointer, which must be freed by the user
+// This function does allocate the final dest pointer, which must be freed by the user (with the free of the game's
+// gol_allocator if it has one). gol_render can reuse a buffer
 // For custom ALIVE/DEAD character, provide src with atleast 2 characters, otherwise NULL
 // Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_OK
 gol_err gol_tostring(struct gameoflife *game, char **dest, const char *src) {
-    if (game->board == NULL) return GOL_ERR_INIT;
+    gol_err error;
+    size_t len;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
 
-    // allocate memory for a string that contains all positions
-    size_t len = ((size_t)game->cols + 1) /* +1 for '\n' */ * game->rows;
-    char *str = (char *) malloc(sizeof(char) * (len + 1 /* +1 for '\0' */));
+    // ask for the size first, it's the only way gol_render fails here
+    gol_render(game, NULL, 0, &len, src);
+    char *str = (char *) gol_allocresult(&game->allocator, sizeof(char) * len);
     if (str == NULL) return GOL_ERR_NOMEM;
-
-    // get the characters to use from 'src'
-    // if 'src' is NULL, then use defaults instead
-    char on_char, off_char;
-    if (src == NULL) {
-        on_char = 'X';
-        off_char = 'O';
-    } else {
-        on_char = src[0];
-        off_char = src[1];
+    if ((error = gol_render(game, str, len, NULL, src)) != GOL_ERR_OK) {
+        gol_deallocresult(&game->allocator, str);
+        return error;
     }
 
-    // insert the characters into the string
-    int i = 0;
-    for (gol_pos y = 0; y < game->rows; y++) {
-        if (y != 0) str[i++] = '\n';
-        for (gol_pos x = 0; x < game->cols; x++) {
-            // set the character based on the value from the board
-            unsigned int pos = gol_2dto1d(game, x, y);
-            if (game->board[pos] == true) str[i++] = on_char;
-            else str[i++] = off_char;
+    *dest = str;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Provides the rows and columns of the overview of a w x h rectangle in blocks of block x block cells
+static void gol_overviewsize(gol_pos w, gol_pos h, gol_pos block, size_t *rows, size_t *cols) {
+    *rows = ((size_t)h + (size_t)block - 1) / (size_t)block;
+    *cols = ((size_t)w + (size_t)block - 1) / (size_t)block;
+}
+
+// PRIVATE
+// Checks the arguments of an overview (see gol_overview)
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+static gol_err gol_overviewcheck(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h,
+                                 gol_pos block) {
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || y < 0 || w < 0 || h < 0 || w > game->cols - x || h > game->rows - y) return GOL_ERR_RANGE;
+    // the population of a block must fit its count
+    if (block <= 0 || block > GOL_OVERVIEW_MAX_BLOCK) return GOL_ERR_RANGE;
+    return GOL_ERR_OK;
+}
+
+// Downsamples the w x h rectangle of the board starting at column x, row y into blocks of block x block cells, and
+// writes the number of live cells of each block into 'counts', one row of blocks after the other. The blocks of the
+// last column and row are cut off by the edge of the rectangle
+// The blocks are counted with the popcount kernel (see gol_region_population), so the cost scales with the cells of
+// the rectangle over 64 plus the blocks written, the board itself is never rendered
+// 'needed' receives the number of blocks. If 'size' (in blocks) is smaller than that nothing is written
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (rectangle off the board, block out of range or counts
+// too small), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_overview(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, gol_pos block,
+                     uint32_t *counts, size_t size, size_t *needed) {
+    gol_err error;
+    size_t rows, cols;
+    if ((error = gol_overviewcheck(game, x, y, w, h, block)) != GOL_ERR_OK) return error;
+    gol_overviewsize(w, h, block, &rows, &cols);
+    if (needed != NULL) *needed = rows * cols;
+    if (counts == NULL || size < rows * cols) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    for (size_t by = 0; by < rows; by++) {
+        gol_pos y0 = y + (gol_pos)by * block, bh = y + h - y0 < block ? y + h - y0 : block;
+        for (size_t bx = 0; bx < cols; bx++) {
+            gol_pos x0 = x + (gol_pos)bx * block, bw = x + w - x0 < block ? x + w - x0 : block;
+            counts[by * cols + bx] = (uint32_t) gol_countregion(game, x0, y0, bw, bh);
         }
     }
-    // finally null-terminate the string
-    str[i] = (char)'\0';
+    return GOL_ERR_OK;
+}
 
-    *dest = str;
+// Renders the overview of the w x h rectangle of the board starting at column x, row y (see gol_overview) as text into
+// a buffer provided by the caller, with each row of blocks separated by a new line
+// Every block is a character of 'ramp', from the first for an empty block to the last for a full one, by the share of
+// its cells alive. any live cell shows as more than the first character. ramp needs at least 2 characters, NULL
+// gives GOL_OVERVIEW_RAMP. 'needed' and 'size' work like they do for gol_render
+// Possible Errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (rectangle off the board, block out of range, ramp too
+// short or buffer too small), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_render_overview(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, gol_pos block,
+                            char *buf, size_t size, size_t *needed, const char *ramp) {
+    gol_err error;
+    size_t rows, cols;
+    if ((error = gol_overviewcheck(game, x, y, w, h, block)) != GOL_ERR_OK) return error;
+    if (ramp == NULL) ramp = GOL_OVERVIEW_RAMP;
+    const size_t levels = strlen(ramp);
+    if (levels < 2) return GOL_ERR_RANGE;
+
+    gol_overviewsize(w, h, block, &rows, &cols);
+    size_t len = (cols + 1) * rows + (rows == 0);
+    if (needed != NULL) *needed = len;
+    if (buf == NULL || size < len) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    size_t i = 0;
+    for (size_t by = 0; by < rows; by++) {
+        if (by != 0) buf[i++] = '\n';
+        gol_pos y0 = y + (gol_pos)by * block, bh = y + h - y0 < block ? y + h - y0 : block;
+        for (size_t bx = 0; bx < cols; bx++) {
+            gol_pos x0 = x + (gol_pos)bx * block, bw = x + w - x0 < block ? x + w - x0 : block;
+            uint64_t cells = (uint64_t)bw * (uint64_t)bh, population = gol_countregion(game, x0, y0, bw, bh);
+            // rounded up, so only an empty block gets the first character
+            buf[i++] = ramp[(population * (levels - 1) + cells - 1) / cells];
+        }
+    }
+    buf[i] = '\0';
     return GOL_ERR_OK;
 }
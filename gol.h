@@ -2,29 +2,311 @@
 #define C_PLAYGROUND_GOL_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
 
 typedef unsigned int gol_err;
 #define GOL_ERR_OK 0
 #define GOL_ERR_INIT 1
 #define GOL_ERR_NOMEM 2
+#define GOL_ERR_RANGE 3
+#define GOL_ERR_IO 4
 
-typedef short int gol_pos;
+// the way the cells of a board are laid out in memory
+typedef unsigned int gol_storage;
+// one bool per cell in 'board', row-major (the default)
+#define GOL_STORAGE_BYTES 0
+// one bit per cell in 'packed', each row padded to a whole number of 64-bit words
+// bit (x % 64) of word (x / 64) of a row is the cell at column x
+#define GOL_STORAGE_PACKED 1
+
+// what lies beyond the edges of the board
+typedef unsigned int gol_boundary;
+// cells off the board are always dead (the default)
+#define GOL_BOUNDARY_DEAD 0
+// the board wraps around, the cell left of the first column is the last column (same for rows)
+#define GOL_BOUNDARY_TORUS 1
+// the board is reflected at its edges, the cell left of the first column is the first column (same for rows)
+#define GOL_BOUNDARY_MIRROR 2
+
+// where gol_tick computes the next generation
+typedef unsigned int gol_backend;
+// on the cpu, by the simd kernels and the game's threads (the default)
+#define GOL_BACKEND_CPU 0
+// on the first OpenCL gpu found, which keeps the board in its memory between ticks. only packed boards without tile
+// tracking or a history can tick there, any other board (or a machine without a gpu) ticks on the cpu instead
+#define GOL_BACKEND_GPU 1
+
+// a life-like rule: which neighbor counts give birth to a dead cell and which let a live cell survive
+// written in B/S notation, e.g. "B3/S23" (conway), "B36/S23" (highlife), "B3678/S34678" (day & night), "B2/S" (seeds)
+struct gol_rule {
+    // bit n is set if a dead cell with n live neighbors is born, or a live cell with n live neighbors survives
+    uint16_t birth;
+    uint16_t survive;
+    // next condition of a cell indexed by [is_alive][live_neighbors], compiled from the masks above
+    bool next[2][9];
+    // whether this is B3/S23, which the tick kernels have dedicated code for
+    bool conway;
+};
+
+// where the memory of a board comes from (see gol_options.allocator), e.g. an arena, huge pages or a numa node
+// 'alloc' returns 'size' bytes aligned to 'alignment' (a power of two, at least GOL_ALIGN) or NULL if it's out of
+// memory, 'free' releases memory 'alloc' returned. both are passed 'user', and only called from the thread that called
+// into the library, never from its workers
+struct gol_allocator {
+    void *(*alloc)(void *user, size_t size, size_t alignment);
+    void (*free)(void *user, void *ptr);
+    void *user;
+};
+
+// alignment of every allocation, a cache line (and a whole simd vector)
+#define GOL_ALIGN 64
+// alignment of allocations of at least this size, so they can be backed by 2 MB huge pages
+#define GOL_ALIGN_HUGE ((size_t)2 << 20)
+
+// which cpus the worker threads of a game run on (see gol_options.pin), only supported on linux
+typedef unsigned int gol_pinning;
+// wherever the scheduler puts them (the default)
+#define GOL_PIN_NONE 0
+// one cpu per worker, worker i on the i-th cpu the process may run on
+#define GOL_PIN_CORES 1
+// the workers are split into consecutive groups, one per numa node, each running on any cpu of its node. since every
+// worker first touches the rows it ticks (see gol_options.threads), each node then holds the rows its workers tick
+#define GOL_PIN_NODES 2
+
+// the rule gol_init and a NULL gol_options.rule give
+#define GOL_RULE_CONWAY "B3/S23"
+// characters gol_rulestring needs at most, including the null-terminator
+#define GOL_RULE_MAX 22
+
+// optional settings for gol_init_opts, a zeroed struct gives the same board as gol_init
+struct gol_options {
+    gol_storage storage;
+    // number of threads gol_tick runs on, 0 or 1 ticks on the calling thread only
+    // the worker threads are started by gol_init_opts and stopped by gol_free. each of them zeroes the rows of the board
+    // it ticks, so on a numa system the pages of every band of rows are placed on the node of the worker ticking it
+    unsigned int threads;
+    // divide the board into GOL_TILE x GOL_TILE tiles, and only tick the tiles that changed last generation
+    // or border one that did. cells that are written without gol_setcell need a call to gol_markdirty
+    bool tiles;
+    gol_boundary boundary;
+    // B/S notation of the rule to run (see gol_parserule), NULL for GOL_RULE_CONWAY
+    const char *rule;
+    // collect gol_stats on every tick (see gameoflife.stats)
+    bool stats;
+    // number of recent board hashes gol_tick keeps for gol_cycle, 0 to not track the board's hash
+    unsigned int history;
+    // where the board ticks (see GOL_BACKEND_GPU), gol_backendname tells which one it ended up on
+    gol_backend backend;
+    // allocates the board and everything else the game holds, NULL for the system heap (see gol_allocator)
+    const struct gol_allocator *allocator;
+    // pins the worker threads to cpus, see GOL_PIN_NODES. the calling thread is worker 0, and is pinned as well until
+    // gol_free, which gives it back the cpus it could run on before gol_init_opts
+    gol_pinning pin;
+};
+
+// width and height of the tiles used for tile tracking (see gol_options.tiles)
+#define GOL_TILE 64
+// number of generations gol_tick_n advances a band of rows by while it's in cache, and the bytes of cache it aims for
+#define GOL_TICK_DEPTH 8
+#define GOL_TICK_CACHE ((size_t)1 << 20)
+// bits of precision of the density of gol_populate_seeded
+#define GOL_FILL_BITS 16
+
+// worker threads owned by a game (see gol_options.threads)
+struct gol_pool;
+// cells counted by one worker during a tick
+struct gol_tickcount;
+// the hash of the board at a generation, kept for gol_cycle
+struct gol_history;
+// the device and buffers of a board ticking on the gpu
+struct gol_gpu;
+
+// define as 0 to compile the collection of gol_stats out of gol_tick, gol_options.stats is ignored then
+#ifndef GOL_STATS
+#define GOL_STATS 1
+#endif
+
+// what the last gol_tick or gol_tick_n did, collected with gol_options.stats
+struct gol_stats {
+    // the generation the board is at, and the number of generations the call advanced it by
+    uint64_t generation;
+    uint64_t generations;
+    // live cells on the board, and the cells born and died in the generation that was computed. these are counted by
+    // the tick itself as it writes every row, gol_tick_n doesn't count them and clears 'counted'
+    bool counted;
+    uint64_t population;
+    uint64_t births;
+    uint64_t deaths;
+    // wall time of the call, and the bytes of the board it read and wrote (every row counted once per generation)
+    uint64_t nanoseconds;
+    uint64_t bytes;
+};
+
+// a row/column count or coordinate on a board
+// 64-bit, so boards aren't limited to 32767 cells per side. rows * cols cells are indexed with a size_t,
+// existing callers passing any integer type (int, short) to gol_init keep working unchanged
+typedef int64_t gol_pos;
 struct gameoflife {
     gol_pos rows, cols;
+    gol_storage storage;
+    gol_boundary boundary;
+    // the rule every tick applies, changed with gol_setrule
+    struct gol_rule rule;
+    // GOL_STORAGE_BYTES: the current generation
     bool *board;
+    // GOL_STORAGE_BYTES: scratch buffer receiving the next generation, swapped with board every tick
+    bool *back;
+    // GOL_STORAGE_PACKED: the current generation and its back buffer, 'words' 64-bit words per row
+    uint64_t *packed;
+    uint64_t *packed_back;
+    size_t words;
+    // ghost cells around the board, refreshed from the board by every tick according to the boundary mode
+    // halo_top/halo_bottom hold columns -1 to cols of the rows above and below the board (byte boards only),
+    // halo_west/halo_east the cells left and right of every row
+    bool *halo_top;
+    bool *halo_bottom;
+    bool *halo_west;
+    bool *halo_east;
+    // worker pool used by gol_tick, NULL when ticking on the calling thread only
+    struct gol_pool *pool;
+    // tile tracking: number of tiles across and down, whether each changed last generation, and whether
+    // each is being ticked this generation. tile_changed is NULL without tile tracking
+    size_t tiles_x, tiles_y;
+    bool *tile_changed;
+    bool *tile_active;
+    // number of tiles ticked by the last gol_tick
+    size_t active_tiles;
+    // scratch buffers of gol_tick_n, allocated on its first call
+    unsigned char *scratch;
+    size_t scratch_size;
+    // generations ticked since gol_init_opts, or since the generation of the snapshot the board was loaded from
+    uint64_t generation;
+    // the snapshot mapped by gol_snapshot_map and the board within it, which is one of the packed buffers
+    void *mapping;
+    size_t mapping_size;
+    uint64_t *mapped;
+    // statistics of the last tick (collected if 'counting', from gol_options.stats) and the counts of every worker
+    // they're summed from, NULL unless there are statistics or a history to collect
+    struct gol_stats stats;
+    bool counting;
+    struct gol_tickcount *tickcounts;
+    // live cells on the board while population_known is set, so gol_population doesn't have to count them. known for
+    // a new or cleared board, after every gol_tick with gol_options.stats, and kept up to date by gol_setcell
+    uint64_t population;
+    bool population_known;
+    // the hash of the board while hash_known is set (see gol_hash), known and kept up to date in the same way as the
+    // population, but by every gol_tick of a game with a history
+    uint64_t hash;
+    bool hash_known;
+    // ring of the hashes of the last history_size generations ticked (gol_options.history), history_next is where the
+    // next one goes. NULL without a history, emptied whenever the board is written to
+    struct gol_history *history;
+    size_t history_size, history_count, history_next;
+    // the gpu the board ticks on (GOL_BACKEND_GPU), NULL on the cpu. the board in host memory falls behind the one on
+    // the device as it ticks, every function reading the board brings it up to date first (see gol_sync)
+    struct gol_gpu *gpu;
+    // where all of the memory above comes from, and goes back to on gol_free
+    struct gol_allocator allocator;
 };
 
-// initializes the gameoflife struct with the provided values. allocated the board.
+// initializes the gameoflife struct with the provided values. allocates the board and its back buffer.
 gol_err gol_init(struct gameoflife *game, gol_pos rows, gol_pos cols);
+// same as gol_init, but with the settings in opts applied (opts can be NULL for the defaults)
+gol_err gol_init_opts(struct gameoflife *game, gol_pos rows, gol_pos cols, const struct gol_options *opts);
+// compiles a rule in B/S notation ("B36/S23", also "S23/B36" or the plain "23/36"), letters are case insensitive
+gol_err gol_parserule(const char *notation, struct gol_rule *rule);
+// writes the rule in B/S notation into dest, which must hold GOL_RULE_MAX characters
+gol_err gol_rulestring(const struct gol_rule *rule, char *dest);
+// replaces the rule of the game with the one in B/S notation (see gol_parserule)
+gol_err gol_setrule(struct gameoflife *game, const char *notation);
 // destructs the game and releases all associated memory (except for the provided pointer itself)
 gol_err gol_free(struct gameoflife *game);
+// provides the bytes of memory the game holds (including the memory it holds on a gpu)
+gol_err gol_memory(const struct gameoflife *game, size_t *bytes);
+// reads the cell at column x, row y into 'alive', regardless of the storage used
+gol_err gol_getcell(const struct gameoflife *game, gol_pos x, gol_pos y, bool *alive);
+// sets the cell at column x, row y, regardless of the storage used
+gol_err gol_setcell(struct gameoflife *game, gol_pos x, gol_pos y, bool alive);
+// sets 'count' cells of row y from column x on, much faster than a gol_setcell per cell
+gol_err gol_setrun(struct gameoflife *game, gol_pos x, gol_pos y, gol_pos count, bool alive);
+// marks the whole board as changed for tile tracking and forgets its population, required after writing to the board
+// directly
+gol_err gol_markdirty(struct gameoflife *game);
+// kills every cell of the board
+gol_err gol_clear(struct gameoflife *game);
+// provides the number of live cells on the board
+gol_err gol_population(const struct gameoflife *game, uint64_t *population);
+// provides the number of live cells in the w x h rectangle of the board starting at column x, row y
+gol_err gol_region_population(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h,
+                              uint64_t *population);
+// provides the smallest rectangle holding every live cell (column x, row y, w x h), all zero for an empty board
+gol_err gol_bbox(const struct gameoflife *game, gol_pos *x, gol_pos *y, gol_pos *w, gol_pos *h);
+// provides a 64-bit hash of the board, the same for the same cells whatever the storage and settings
+gol_err gol_hash(const struct gameoflife *game, uint64_t *hash);
+// looks for the current board in the history (see gol_options.history): 'period' receives the number of generations
+// since the board was last the same, 1 for a still life and 0 if it isn't in the history, 'since' the generation then
+gol_err gol_cycle(const struct gameoflife *game, uint64_t *period, uint64_t *since);
 // populates the board with random values (doesn't specify srand)
 gol_err gol_populate(struct gameoflife *game);
+// populates the board with random values from 'seed', each cell alive with a probability of 'density' (0 to 1)
+// the same seed always gives the same board, filled in parallel by the game's threads
+gol_err gol_populate_seeded(struct gameoflife *game, uint64_t seed, double density);
+// copies the board back from the gpu it ticks on, required before reading or writing the board directly
+gol_err gol_sync(const struct gameoflife *game);
+// provides the name of the device the board ticks on, "cpu" or the name of the gpu
+const char *gol_backendname(const struct gameoflife *game);
 // ticks the board forward, checking all associated rules and making changes accordingly
+// never allocates; the next generation is written into the back buffer and swapped in
+// fails with GOL_ERR_IO if the board ticks on a gpu and the device fails
 gol_err gol_tick(struct gameoflife *game);
+// ticks the board forward n generations, processing cache-sized bands several generations at a time
+// gives exactly the same board as n calls to gol_tick, and fails with GOL_ERR_IO like it if the gpu does
+gol_err gol_tick_n(struct gameoflife *game, unsigned long n);
+// allocates the scratch buffers gol_tick_n uses for n generations up front, after which gol_tick_n never allocates
+gol_err gol_tick_n_reserve(struct gameoflife *game, unsigned long n);
 // places an allocated string into 'dest' of the board, rows separated by newlines
-// you must call free after you are done using the value in dest
+// you must call free after you are done using the value in dest (or the free of the game's gol_options.allocator)
 // src is a char array with a length of 2 providing the on/off values (can be NULL)
 gol_err gol_tostring(struct gameoflife *game, char **dest, const char *src);
 
+// receives the text of a board in chunks from gol_render_stream, returns false if it couldn't be written
+typedef bool (*gol_write_fn)(void *user, const char *data, size_t size);
+// most characters gol_render_stream passes to a single write
+#define GOL_RENDER_CHUNK 4096
+// renders the board as text into 'buf', the same text as gol_tostring without allocating
+// 'needed' receives the size of the buffer required, nothing is written if 'size' is less than that
+gol_err gol_render(const struct gameoflife *game, char *buf, size_t size, size_t *needed, const char *src);
+// renders the w x h rectangle of the board starting at column x, row y as text into 'buf', like gol_render, reading
+// only the cells of the rectangle
+gol_err gol_render_region(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, char *buf,
+                          size_t size, size_t *needed, const char *src);
+// renders the board as text, passing it to 'write' a chunk at a time
+gol_err gol_render_stream(const struct gameoflife *game, gol_write_fn write, void *user, const char *src);
+// renders the board as text straight to a file
+gol_err gol_render_file(const struct gameoflife *game, FILE *file, const char *src);
+
+// largest block of gol_overview, whose population still fits a uint32_t
+#define GOL_OVERVIEW_MAX_BLOCK 65535
+// characters gol_render_overview draws blocks with by default, from empty to full
+#define GOL_OVERVIEW_RAMP " .:-=+*#%@"
+// counts the live cells of every block x block block of the w x h rectangle starting at column x, row y into 'counts',
+// row by row: (w + block - 1) / block columns and (h + block - 1) / block rows of blocks, the last ones cut off by the
+// rectangle. 'needed' receives the number of blocks, nothing is written if 'size' is less than that
+gol_err gol_overview(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, gol_pos block,
+                     uint32_t *counts, size_t size, size_t *needed);
+// renders the overview of gol_overview as text into 'buf' like gol_render, a character of 'ramp' per block by its
+// share of live cells (NULL for GOL_OVERVIEW_RAMP)
+gol_err gol_render_overview(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h, gol_pos block,
+                            char *buf, size_t size, size_t *needed, const char *ramp);
+
+// provides the name of the simd kernel gol_tick uses ("scalar", "sse2", "avx2" or "neon")
+// the best kernel the cpu supports is picked on first use
+// packed 64x64, 256x256 and 1024x1024 boards under B3/S23 with dead or torus edges (and no tiles) tick with versions
+// of the kernel specialized for their size
+const char *gol_kernelname(void);
+// forces the kernel with the provided name (NULL goes back to automatic detection)
+gol_err gol_setkernel(const char *name);
+
 #endif //C_PLAYGROUND_GOL_H
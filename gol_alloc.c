@@ -0,0 +1,97 @@
+#include "gol_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define GOL_ALLOC_POSIX
+#include <sys/mman.h>
+#endif
+
+// PRIVATE
+// gol_allocator.alloc of the system heap, which asks the kernel for huge pages for the largest allocations where it can
+static void *gol_sysalloc(void *user, size_t size, size_t alignment) {
+    (void) user;
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#elif defined(GOL_ALLOC_POSIX)
+    void *ptr;
+    if (posix_memalign(&ptr, alignment, size) != 0) return NULL;
+#ifdef MADV_HUGEPAGE
+    // only a hint, memory without huge pages works all the same
+    if (alignment >= GOL_ALIGN_HUGE)
+        madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return ptr;
+#else
+    // over-allocates, and keeps the pointer malloc returned right before the aligned memory
+    unsigned char *raw = (unsigned char *) malloc(size + alignment + sizeof(void *));
+    if (raw == NULL) return NULL;
+    uintptr_t aligned = ((uintptr_t)(raw + sizeof(void *)) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    memcpy((void *) (aligned - sizeof(void *)), &raw, sizeof(void *));
+    return (void *) aligned;
+#endif
+}
+
+// PRIVATE
+// gol_allocator.free of the system heap
+static void gol_sysfree(void *user, void *ptr) {
+    (void) user;
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#elif defined(GOL_ALLOC_POSIX)
+    free(ptr);
+#else
+    void *raw;
+    memcpy(&raw, (unsigned char *) ptr - sizeof(void *), sizeof(void *));
+    free(raw);
+#endif
+}
+
+// Copies the provided allocator, or the one of the system heap if it's NULL, which is what every engine allocates with
+// Possible errors (return value): GOL_ERR_RANGE (a function is missing), GOL_ERR_OK
+gol_err gol_allocator_init(struct gol_allocator *dest, const struct gol_allocator *allocator) {
+    if (allocator == NULL) {
+        dest->alloc = gol_sysalloc;
+        dest->free = gol_sysfree;
+        dest->user = NULL;
+        return GOL_ERR_OK;
+    }
+    if (allocator->alloc == NULL || allocator->free == NULL) return GOL_ERR_RANGE;
+    *dest = *allocator;
+    return GOL_ERR_OK;
+}
+
+// Allocates count * size bytes, but never less than a single byte, so an allocation only fails for lack of memory
+// Returns: The memory, or NULL if there's none left or count * size doesn't fit a size_t
+void *gol_alloc(const struct gol_allocator *allocator, size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return NULL;
+    size_t bytes = count * size;
+    if (bytes == 0) bytes = 1;
+    return allocator->alloc(allocator->user, bytes, bytes >= GOL_ALIGN_HUGE ? GOL_ALIGN_HUGE : GOL_ALIGN);
+}
+
+void *gol_zalloc(const struct gol_allocator *allocator, size_t count, size_t size) {
+    void *ptr = gol_alloc(allocator, count, size);
+    if (ptr != NULL) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void gol_dealloc(const struct gol_allocator *allocator, void *ptr) {
+    if (ptr != NULL) allocator->free(allocator->user, ptr);
+}
+
+// Allocates memory the caller releases, with the system heap's own malloc rather than gol_sysalloc, since free can't
+// release aligned memory everywhere
+// Returns: The memory, or NULL if there's none left
+void *gol_allocresult(const struct gol_allocator *allocator, size_t size) {
+    if (allocator->alloc == gol_sysalloc) return malloc(size ? size : 1);
+    return gol_alloc(allocator, size, 1);
+}
+
+void gol_deallocresult(const struct gol_allocator *allocator, void *ptr) {
+    if (allocator->alloc == gol_sysalloc) free(ptr);
+    else gol_dealloc(allocator, ptr);
+}
@@ -0,0 +1,24 @@
+#ifndef C_PLAYGROUND_GOL_ALLOC_H
+#define C_PLAYGROUND_GOL_ALLOC_H
+
+// PRIVATE
+// Allocation through a gol_allocator, shared by every engine holding board memory. Not part of the public API.
+
+#include "gol.h"
+
+// copies 'allocator' into dest, or the allocator of the system heap if it's NULL
+// fails with GOL_ERR_RANGE if either of its functions is missing
+gol_err gol_allocator_init(struct gol_allocator *dest, const struct gol_allocator *allocator);
+// allocates 'count' elements of 'size' bytes, aligned to GOL_ALIGN (GOL_ALIGN_HUGE for allocations at least that
+// large), NULL if there's no memory or the size overflows
+void *gol_alloc(const struct gol_allocator *allocator, size_t count, size_t size);
+// the same as gol_alloc, with the memory zeroed
+void *gol_zalloc(const struct gol_allocator *allocator, size_t count, size_t size);
+// releases memory from gol_alloc or gol_zalloc, nothing for NULL
+void gol_dealloc(const struct gol_allocator *allocator, void *ptr);
+// allocates memory handed over to the caller, who releases it with free, or with the free of a custom allocator
+void *gol_allocresult(const struct gol_allocator *allocator, size_t size);
+// releases memory from gol_allocresult that never made it to the caller
+void gol_deallocresult(const struct gol_allocator *allocator, void *ptr);
+
+#endif //C_PLAYGROUND_GOL_ALLOC_H
@@ -0,0 +1,117 @@
+#include "gol_async.h"
+
+#include <string.h>
+
+// PRIVATE
+// Copies the cells of the game into a frame of the same size and storage, along with whatever it knows of them
+// Possible errors (return value): GOL_ERR_IO (the board couldn't be fetched from a gpu), GOL_ERR_OK
+static gol_err gol_async_copy(struct gameoflife *frame, const struct gameoflife *game) {
+    gol_err error;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+    if (game->storage == GOL_STORAGE_PACKED)
+        memcpy(frame->packed, game->packed, (size_t)game->rows * game->words * sizeof(uint64_t));
+    else
+        memcpy(frame->board, game->board, (size_t)game->rows * (size_t)game->cols * sizeof(bool));
+    gol_markdirty(frame);
+    frame->generation = game->generation;
+    frame->population = game->population;
+    frame->population_known = game->population_known;
+    frame->hash = game->hash;
+    frame->hash_known = game->hash_known;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Main loop of the simulation thread: ticks the game 'step' generations, copies it into the back frame and publishes
+// that, taking the frame published before as the next back frame (unless the renderer took it, then it's the one the
+// renderer held before). nothing ever waits, the exchange is all the synchronization there is
+static void *gol_async_run(void *arg) {
+    struct gol_async *async = (struct gol_async *) arg;
+    while (!__atomic_load_n(&async->stop, __ATOMIC_ACQUIRE)) {
+        gol_err error = gol_tick_n(async->game, async->step);
+        if (error == GOL_ERR_OK) error = gol_async_copy(&async->frames[async->back], async->game);
+        if (error != GOL_ERR_OK) {
+            // read by gol_async_error while the renderer runs, and by gol_async_stop once the thread is joined
+            __atomic_store_n(&async->error, error, __ATOMIC_RELEASE);
+            break;
+        }
+        unsigned int published = __atomic_exchange_n(&async->shared, async->back | GOL_ASYNC_FRESH, __ATOMIC_ACQ_REL);
+        async->back = published & ~GOL_ASYNC_FRESH;
+    }
+    return NULL;
+}
+
+// Sets up the three frames with the size, storage, rule and boundary of the game, and starts the simulation thread
+// The game keeps its own settings (threads, tiles, gpu) while it ticks, the frames are plain boards in memory from the
+// game's allocator, which is only called from here and gol_async_stop, never from the simulation thread
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_async_start(struct gol_async *async, struct gameoflife *game, unsigned long step) {
+    gol_err error;
+    memset(async, 0, sizeof(struct gol_async));
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+
+    char rule[GOL_RULE_MAX];
+    gol_rulestring(&game->rule, rule);
+    struct gol_options opts = {0};
+    opts.storage = game->storage;
+    opts.boundary = game->boundary;
+    opts.rule = rule;
+    opts.allocator = &game->allocator;
+    for (int i = 0; i < 3; i++) {
+        if ((error = gol_init_opts(&async->frames[i], game->rows, game->cols, &opts)) != GOL_ERR_OK) {
+            gol_async_stop(async);
+            return error;
+        }
+    }
+    // the renderer starts out with the board as it is, and the simulation writes into the frame nobody holds
+    if ((error = gol_async_copy(&async->frames[0], game)) != GOL_ERR_OK) {
+        gol_async_stop(async);
+        return error;
+    }
+    async->front = 0;
+    async->shared = 1;
+    async->back = 2;
+    async->game = game;
+    async->step = step > 0 ? step : 1;
+    // the simulation thread must not call the allocator, so gol_tick_n gets its scratch buffers here
+    if ((error = gol_tick_n_reserve(game, async->step)) != GOL_ERR_OK) {
+        gol_async_stop(async);
+        return error;
+    }
+
+    if (pthread_create(&async->thread, NULL, gol_async_run, async) != 0) {
+        gol_async_stop(async);
+        return GOL_ERR_NOMEM;
+    }
+    async->running = true;
+    return GOL_ERR_OK;
+}
+
+// Takes the board published last by the simulation, if it published one since the last call, in exchange for the one
+// the renderer held. The board returned is never written to until it's traded in by the next call
+const struct gameoflife *gol_async_latest(struct gol_async *async) {
+    if (__atomic_load_n(&async->shared, __ATOMIC_ACQUIRE) & GOL_ASYNC_FRESH) {
+        unsigned int published = __atomic_exchange_n(&async->shared, async->front, __ATOMIC_ACQ_REL);
+        async->front = published & ~GOL_ASYNC_FRESH;
+    }
+    return &async->frames[async->front];
+}
+
+// Provides the error the simulation thread stopped on, so a renderer can tell it stopped without stopping it first
+// Returns: the error a tick or copy of the simulation failed with, or GOL_ERR_OK while it's still ticking
+gol_err gol_async_error(const struct gol_async *async) {
+    return __atomic_load_n(&async->error, __ATOMIC_ACQUIRE);
+}
+
+// Stops the simulation after the generations it's ticking, and releases the frames
+// Possible errors (return value): the error a tick or copy of the simulation failed with, GOL_ERR_OK
+gol_err gol_async_stop(struct gol_async *async) {
+    if (async->running) {
+        __atomic_store_n(&async->stop, true, __ATOMIC_RELEASE);
+        pthread_join(async->thread, NULL);
+        async->running = false;
+    }
+    for (int i = 0; i < 3; i++)
+        gol_free(&async->frames[i]);
+    return async->error;
+}
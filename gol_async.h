@@ -0,0 +1,47 @@
+#ifndef C_PLAYGROUND_GOL_ASYNC_H
+#define C_PLAYGROUND_GOL_ASYNC_H
+
+#include "gol.h"
+
+#include <pthread.h>
+
+// Asynchronous simulation: a thread of its own ticks a game as fast as it can, and publishes a copy of the board every
+// few generations through a lock-free triple buffer. a renderer samples the newest published board whenever it draws a
+// frame, so neither waits for the other: the simulation never stops for a slow display, and the display never shows
+// a board that's being written to.
+
+// set in gol_async.shared along with the index of the frame while it's published but not sampled yet
+#define GOL_ASYNC_FRESH 4u
+
+struct gol_async {
+    // the game being ticked, owned by the simulation thread until gol_async_stop
+    struct gameoflife *game;
+    // generations ticked between two published boards
+    unsigned long step;
+    // copies of the board: the one being written by the simulation (back), the last one published (in 'shared',
+    // with GOL_ASYNC_FRESH set until it's sampled) and the one held by the renderer (front)
+    struct gameoflife frames[3];
+    unsigned int back, front;
+    unsigned int shared;
+    // set to stop the simulation thread, and the error it stopped on
+    bool stop;
+    gol_err error;
+    // the simulation thread, while it's running
+    pthread_t thread;
+    bool running;
+};
+
+// copies the board of 'game' into the first frame and starts ticking it on a new thread, publishing a board every
+// 'step' generations (0 for every generation). 'game' must not be touched by the caller until gol_async_stop. whatever
+// ticking the game needs is allocated before the thread starts, so the game's allocator is never called from it
+gol_err gol_async_start(struct gol_async *async, struct gameoflife *game, unsigned long step);
+// provides the newest board published by the simulation, which stays valid and unchanged until the next call
+// to be called from a single thread, the renderer
+const struct gameoflife *gol_async_latest(struct gol_async *async);
+// provides the error the simulation thread stopped on, GOL_ERR_OK while it's ticking (no new board is published after)
+gol_err gol_async_error(const struct gol_async *async);
+// stops and joins the simulation thread and releases the frames, the game is left at the generation it got to
+// returns the error the simulation stopped on, if it did
+gol_err gol_async_stop(struct gol_async *async);
+
+#endif //C_PLAYGROUND_GOL_ASYNC_H
@@ -0,0 +1,405 @@
+#include "gol_batch.h"
+#include "gol_kernel.h"
+#include "gol_thread.h"
+#include "gol_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// PRIVATE
+// Folds the next row of a board into its hash. the shift carries the high bits of every row into the low bits the
+// multiply of the next one spreads upwards, without it the last column would only ever reach the top bit
+static inline uint64_t gol_batchmix(uint64_t hash, uint64_t row) {
+    hash = (hash ^ row) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 29);
+}
+
+// PRIVATE
+// Rounds an offset into the block up to a cache line, so every array of the batch starts on one
+static inline size_t gol_batchalign(size_t offset) {
+    return (offset + 63) & ~(size_t)63;
+}
+
+// PRIVATE
+// Provides a pointer to row y of every board in a buffer of the batch
+static inline uint64_t *gol_batchrow(const struct gol_batch *batch, uint64_t *buf, gol_pos y) {
+    return buf + (size_t)y * batch->boards;
+}
+
+// PRIVATE
+// Provides the row above row 0 (y = -1) or below the last row (y = rows) for the boundary of the batch
+static const uint64_t *gol_batchhalo(const struct gol_batch *batch, gol_pos y) {
+    if (batch->boundary == GOL_BOUNDARY_TORUS) return gol_batchrow(batch, batch->cells, y < 0 ? batch->rows - 1 : 0);
+    if (batch->boundary == GOL_BOUNDARY_MIRROR) return gol_batchrow(batch, batch->cells, y < 0 ? 0 : batch->rows - 1);
+    return batch->zero;
+}
+
+// PRIVATE
+// Hashes the cells of the board in slot s, the same way a tick hashes the generation it computes
+static uint64_t gol_batchhash(const struct gol_batch *batch, size_t s) {
+    uint64_t hash = 0;
+    for (gol_pos y = 0; y < batch->rows; y++)
+        hash = gol_batchmix(hash, gol_batchrow(batch, batch->cells, y)[s]);
+    return hash;
+}
+
+// PRIVATE
+// Forgets the history of the board in slot s, which starts again from its current cells
+static void gol_batchrestart(struct gol_batch *batch, size_t s) {
+    batch->start[s] = batch->generation;
+    batch->hashes[s * batch->history + batch->generation % batch->history] = gol_batchhash(batch, s);
+}
+
+// PRIVATE
+// Swaps the boards in slots a and b, with their cells in both buffers and their history
+static void gol_batchswap(struct gol_batch *batch, size_t a, size_t b) {
+    if (a == b) return;
+    for (gol_pos y = 0; y < batch->rows; y++) {
+        uint64_t *cells = gol_batchrow(batch, batch->cells, y), *next = gol_batchrow(batch, batch->next, y);
+        uint64_t word = cells[a];
+        cells[a] = cells[b];
+        cells[b] = word;
+        word = next[a];
+        next[a] = next[b];
+        next[b] = word;
+    }
+    for (size_t i = 0; i < batch->history; i++) {
+        uint64_t hash = batch->hashes[a * batch->history + i];
+        batch->hashes[a * batch->history + i] = batch->hashes[b * batch->history + i];
+        batch->hashes[b * batch->history + i] = hash;
+    }
+    uint64_t start = batch->start[a];
+    batch->start[a] = batch->start[b];
+    batch->start[b] = start;
+
+    size_t board = batch->board_of[a];
+    batch->board_of[a] = batch->board_of[b];
+    batch->board_of[b] = board;
+    batch->slot_of[batch->board_of[a]] = a;
+    batch->slot_of[batch->board_of[b]] = b;
+}
+
+// PRIVATE
+// Makes a board that was written to run again, moving it back among the running slots if it had settled
+static void gol_batchwake(struct gol_batch *batch, size_t board) {
+    if (batch->period[board] != 0) {
+        batch->period[board] = 0;
+        batch->since[board] = 0;
+        gol_batchswap(batch, batch->slot_of[board], batch->running);
+        batch->running++;
+    }
+    gol_batchrestart(batch, batch->slot_of[board]);
+}
+
+// Initializes 'boards' empty boards of rows x cols cells, all of them (and their history) in one allocation
+// Only the rule, boundary, threads, pin, history and allocator of the options apply, opts can be NULL for the defaults
+// Possible errors (return value): GOL_ERR_RANGE (no boards, a size below 1 or cols above 64, or an invalid rule),
+// GOL_ERR_NOMEM, GOL_ERR_OK
+gol_err gol_batch_init(struct gol_batch *batch, size_t boards, gol_pos rows, gol_pos cols,
+                       const struct gol_options *opts) {
+    gol_err error;
+    memset(batch, 0, sizeof(struct gol_batch));
+    if (boards == 0 || rows < 1 || cols < 1 || cols > 64) return GOL_ERR_RANGE;
+    if ((size_t)rows > SIZE_MAX / 2 / sizeof(uint64_t) / boards) return GOL_ERR_RANGE;
+
+    batch->boards = boards;
+    batch->rows = rows;
+    batch->cols = cols;
+    batch->boundary = opts != NULL ? opts->boundary : GOL_BOUNDARY_DEAD;
+    if (batch->boundary > GOL_BOUNDARY_MIRROR) return GOL_ERR_RANGE;
+    const char *rule = opts != NULL && opts->rule != NULL ? opts->rule : GOL_RULE_CONWAY;
+    if ((error = gol_parserule(rule, &batch->rule)) != GOL_ERR_OK) return error;
+    batch->history = opts != NULL && opts->history > 0 ? opts->history : GOL_BATCH_HISTORY;
+    if (batch->history > SIZE_MAX / sizeof(uint64_t) / boards) return GOL_ERR_RANGE;
+    if ((error = gol_allocator_init(&batch->allocator, opts != NULL ? opts->allocator : NULL)) != GOL_ERR_OK)
+        return error;
+
+    // lay every array out in the block, each on a cache line of its own
+    size_t words = (size_t)rows * boards, offsets[10], size = 0;
+    const size_t sizes[10] = {
+            words * sizeof(uint64_t), words * sizeof(uint64_t), boards * sizeof(uint64_t),
+            boards * sizeof(size_t), boards * sizeof(size_t),
+            boards * batch->history * sizeof(uint64_t), boards * sizeof(uint64_t), boards * sizeof(uint64_t),
+            boards * sizeof(uint64_t), boards * sizeof(uint64_t)
+    };
+    for (int i = 0; i < 10; i++) {
+        offsets[i] = size;
+        if (sizes[i] > SIZE_MAX - 64 - size) return GOL_ERR_RANGE;
+        size = gol_batchalign(size + sizes[i]);
+    }
+    batch->block = gol_zalloc(&batch->allocator, size, 1);
+    if (batch->block == NULL) return GOL_ERR_NOMEM;
+    batch->block_size = size;
+
+    unsigned char *block = (unsigned char *) batch->block;
+    batch->cells = (uint64_t *) (block + offsets[0]);
+    batch->next = (uint64_t *) (block + offsets[1]);
+    batch->zero = (uint64_t *) (block + offsets[2]);
+    batch->board_of = (size_t *) (block + offsets[3]);
+    batch->slot_of = (size_t *) (block + offsets[4]);
+    batch->hashes = (uint64_t *) (block + offsets[5]);
+    batch->hash = (uint64_t *) (block + offsets[6]);
+    batch->start = (uint64_t *) (block + offsets[7]);
+    batch->period = (uint64_t *) (block + offsets[8]);
+    batch->since = (uint64_t *) (block + offsets[9]);
+
+    // every board starts out empty and running, in the slot of its own index. an empty board hashes to 0
+    for (size_t b = 0; b < boards; b++) {
+        batch->board_of[b] = b;
+        batch->slot_of[b] = b;
+    }
+    batch->running = boards;
+
+    unsigned int threads = opts != NULL ? opts->threads : 0;
+    if (threads > 1) {
+        if ((error = gol_pool_create(&batch->pool, threads, opts->pin, &batch->allocator)) != GOL_ERR_OK) {
+            gol_batch_free(batch);
+            return error;
+        }
+    }
+    return GOL_ERR_OK;
+}
+
+// Releases the block of the batch and stops its workers
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_batch_free(struct gol_batch *batch) {
+    if (batch->pool)
+        gol_pool_destroy(batch->pool);
+    if (batch->block)
+        gol_dealloc(&batch->allocator, batch->block);
+    memset(batch, 0, sizeof(struct gol_batch));
+    return GOL_ERR_OK;
+}
+
+// Provides the bytes of memory held by the batch, its block and the batch itself
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_batch_memory(const struct gol_batch *batch, size_t *bytes) {
+    *bytes = sizeof(struct gol_batch) + batch->block_size;
+    return GOL_ERR_OK;
+}
+
+// Reads the cell at column x, row y of a board
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_getcell(const struct gol_batch *batch, size_t board, gol_pos x, gol_pos y, bool *alive) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards || x < 0 || x >= batch->cols || y < 0 || y >= batch->rows) return GOL_ERR_RANGE;
+    *alive = (gol_batchrow(batch, batch->cells, y)[batch->slot_of[board]] >> x) & 1;
+    return GOL_ERR_OK;
+}
+
+// Sets the cell at column x, row y of a board, the board's history starts over
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_setcell(struct gol_batch *batch, size_t board, gol_pos x, gol_pos y, bool alive) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards || x < 0 || x >= batch->cols || y < 0 || y >= batch->rows) return GOL_ERR_RANGE;
+    uint64_t *word = gol_batchrow(batch, batch->cells, y) + batch->slot_of[board];
+    *word = alive ? *word | (uint64_t)1 << x : *word & ~((uint64_t)1 << x);
+    gol_batchwake(batch, board);
+    return GOL_ERR_OK;
+}
+
+// Populates every board with random cells, each alive with a probability of 'density' (from 0 to 1)
+// Board b gets exactly the cells gol_populate_seeded(game, seed + b, density) gives a rows x cols board
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (density not within [0, 1]), GOL_ERR_OK
+gol_err gol_batch_populate_seeded(struct gol_batch *batch, uint64_t seed, double density) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    // also catches NaN
+    if (!(density >= 0.0 && density <= 1.0)) return GOL_ERR_RANGE;
+
+    uint32_t threshold = (uint32_t) (density * (double) (1u << GOL_FILL_BITS) + 0.5);
+    unsigned int lowest = 0;
+    while (lowest < GOL_FILL_BITS && !((threshold >> lowest) & 1))
+        lowest++;
+    const uint64_t mask = batch->cols == 64 ? ~(uint64_t)0 : ((uint64_t)1 << batch->cols) - 1;
+
+    for (size_t b = 0; b < batch->boards; b++) {
+        batch->period[b] = 0;
+        batch->since[b] = 0;
+        // a row of a board is its single word, so word y of the stream
+        for (gol_pos y = 0; y < batch->rows; y++) {
+            uint64_t cells = threshold >> GOL_FILL_BITS ? ~(uint64_t)0
+                                                          : gol_fillword(seed + b, threshold, lowest, (uint64_t)y);
+            gol_batchrow(batch, batch->cells, y)[batch->slot_of[b]] = cells & mask;
+        }
+    }
+    batch->running = batch->boards;
+    for (size_t s = 0; s < batch->boards; s++)
+        gol_batchrestart(batch, s);
+    return GOL_ERR_OK;
+}
+
+// Replaces a board with the top left rows x cols cells of a game of at least that size
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_load(struct gol_batch *batch, size_t board, const struct gameoflife *game) {
+    gol_err error;
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards || game->rows < batch->rows || game->cols < batch->cols) return GOL_ERR_RANGE;
+
+    size_t s = batch->slot_of[board];
+    for (gol_pos y = 0; y < batch->rows; y++) {
+        uint64_t word = 0;
+        for (gol_pos x = 0; x < batch->cols; x++) {
+            bool alive;
+            if ((error = gol_getcell(game, x, y, &alive)) != GOL_ERR_OK) return error;
+            word |= (uint64_t)alive << x;
+        }
+        gol_batchrow(batch, batch->cells, y)[s] = word;
+    }
+    gol_batchwake(batch, board);
+    return GOL_ERR_OK;
+}
+
+// Writes a board into the top left rows x cols cells of a game of at least that size
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_export(const struct gol_batch *batch, size_t board, struct gameoflife *game) {
+    gol_err error;
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards || game->rows < batch->rows || game->cols < batch->cols) return GOL_ERR_RANGE;
+
+    size_t s = batch->slot_of[board];
+    for (gol_pos y = 0; y < batch->rows; y++) {
+        uint64_t word = gol_batchrow(batch, batch->cells, y)[s];
+        for (gol_pos x = 0; x < batch->cols; x++) {
+            if ((error = gol_setcell(game, x, y, (word >> x) & 1)) != GOL_ERR_OK) return error;
+        }
+    }
+    return GOL_ERR_OK;
+}
+
+// Provides the number of live cells of a board
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_population(const struct gol_batch *batch, size_t board, uint64_t *population) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards) return GOL_ERR_RANGE;
+    size_t s = batch->slot_of[board];
+    uint64_t count = 0;
+    for (gol_pos y = 0; y < batch->rows; y++)
+        count += gol_popcount64(gol_batchrow(batch, batch->cells, y)[s]);
+    *population = count;
+    return GOL_ERR_OK;
+}
+
+// Provides the period of a board and the generation its cycle started at, a period of 0 if it's still running
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_batch_status(const struct gol_batch *batch, size_t board, uint64_t *period, uint64_t *since) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    if (board >= batch->boards) return GOL_ERR_RANGE;
+    *period = batch->period[board];
+    *since = batch->since[board];
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Ticks the running slots [s0, s1) one generation into the next buffer, hashing every slot's new cells on the way
+// Every board is a lane of the row kernel, conway's rule is ticked by the kernel and any other rule word by word
+static void gol_batchrows(struct gol_batch *batch, size_t s0, size_t s1) {
+    // with the torus the cells beyond an edge are the ones cols - 1 columns back, with the mirror the edge cells
+    const uint64_t mask = batch->cols == 64 ? ~(uint64_t)0 : ((uint64_t)1 << batch->cols) - 1;
+    const bool wrap = batch->boundary != GOL_BOUNDARY_DEAD;
+    const struct gol_lanes lanes = {
+            mask, wrap ? 1 : 0, wrap ? (uint64_t)1 << (batch->cols - 1) : 0,
+            batch->boundary == GOL_BOUNDARY_TORUS ? (unsigned int)batch->cols - 1 : 0
+    };
+    const unsigned int shift = lanes.shift;
+    const uint64_t west = lanes.west, east = lanes.east;
+    const gol_lanesrow_fn lanesrow = gol_kernel()->lanesrow;
+    uint64_t *hash = batch->hash;
+
+    for (size_t s = s0; s < s1; s++)
+        hash[s] = 0;
+    for (gol_pos y = 0; y < batch->rows; y++) {
+        const uint64_t *up = y > 0 ? gol_batchrow(batch, batch->cells, y - 1) : gol_batchhalo(batch, -1);
+        const uint64_t *mid = gol_batchrow(batch, batch->cells, y);
+        const uint64_t *down = y + 1 < batch->rows ? gol_batchrow(batch, batch->cells, y + 1)
+                                                   : gol_batchhalo(batch, batch->rows);
+        uint64_t *out = gol_batchrow(batch, batch->next, y);
+
+        if (batch->rule.conway) {
+            lanesrow(&lanes, up + s0, mid + s0, down + s0, out + s0, s1 - s0);
+        } else {
+            for (size_t s = s0; s < s1; s++) {
+                uint64_t u = up[s], m = mid[s], d = down[s];
+                uint64_t uw = (u << 1) | ((u >> shift) & west), ue = (u >> 1) | ((u << shift) & east);
+                uint64_t mw = (m << 1) | ((m >> shift) & west), me = (m >> 1) | ((m << shift) & east);
+                uint64_t dw = (d << 1) | ((d >> shift) & west), de = (d >> 1) | ((d << shift) & east);
+                out[s] = gol_wordrule(&batch->rule, uw, u, ue, mw, m, me, dw, d, de) & mask;
+            }
+        }
+        for (size_t s = s0; s < s1; s++)
+            hash[s] = gol_batchmix(hash[s], out[s]);
+    }
+
+    // a board settles as soon as its new generation hashes like one in its history, which is then where its cycle
+    // started. the history holds generations [generation - history, generation) until the new one replaces the oldest
+    const uint64_t generation = batch->generation + 1;
+    const size_t history = batch->history;
+    const size_t newest = (size_t) (generation % history);
+    for (size_t s = s0; s < s1; s++) {
+        uint64_t *hashes = batch->hashes + s * history;
+        uint64_t back = generation - batch->start[s];
+        if (back > history) back = history;
+        size_t i = newest;
+        for (uint64_t p = 1; p <= back; p++) {
+            i = i > 0 ? i - 1 : history - 1;
+            if (hashes[i] == hash[s]) {
+                batch->period[batch->board_of[s]] = p;
+                batch->since[batch->board_of[s]] = generation - p;
+                break;
+            }
+        }
+        hashes[newest] = hash[s];
+    }
+}
+
+// PRIVATE
+// Ticks a worker's share of the running slots, shares start on a cache line so workers never write to the same one
+static void gol_batchband(void *arg, unsigned int worker, unsigned int workers) {
+    struct gol_batch *batch = (struct gol_batch *) arg;
+    size_t lines = (batch->running + 7) / 8;
+    size_t s0 = lines * worker / workers * 8, s1 = lines * (worker + 1) / workers * 8;
+    if (s1 > batch->running) s1 = batch->running;
+    if (s0 < s1) gol_batchrows(batch, s0, s1);
+}
+
+// Ticks every running board forward one generation, boards that settle stop running
+// The boards still running are kept in the slots at the front, so a tick only walks those
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_batch_tick(struct gol_batch *batch) {
+    if (batch->block == NULL) return GOL_ERR_INIT;
+
+    if (batch->running > 0) {
+        if (batch->pool != NULL)
+            gol_pool_run(batch->pool, gol_batchband, batch);
+        else
+            gol_batchrows(batch, 0, batch->running);
+    }
+    uint64_t *next = batch->next;
+    batch->next = batch->cells;
+    batch->cells = next;
+    batch->generation++;
+
+    // move the boards that settled behind the running ones, with their cells in both buffers so they keep them
+    // however many more times the buffers are swapped
+    for (size_t s = 0; s < batch->running;) {
+        if (batch->period[batch->board_of[s]] == 0) {
+            s++;
+            continue;
+        }
+        for (gol_pos y = 0; y < batch->rows; y++)
+            gol_batchrow(batch, batch->next, y)[s] = gol_batchrow(batch, batch->cells, y)[s];
+        batch->running--;
+        gol_batchswap(batch, s, batch->running);
+    }
+    return GOL_ERR_OK;
+}
+
+// Ticks the running boards forward up to n generations, returning early once every board settled
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_batch_run(struct gol_batch *batch, unsigned long n) {
+    gol_err error;
+    if (batch->block == NULL) return GOL_ERR_INIT;
+    for (unsigned long i = 0; i < n && batch->running > 0; i++) {
+        if ((error = gol_batch_tick(batch)) != GOL_ERR_OK) return error;
+    }
+    return GOL_ERR_OK;
+}
@@ -0,0 +1,79 @@
+#ifndef C_PLAYGROUND_GOL_BATCH_H
+#define C_PLAYGROUND_GOL_BATCH_H
+
+#include "gol.h"
+
+// Batch of small boards of the same size, ticked together: for soup searches running huge numbers of independent
+// boards, where a gameoflife per board would spend more time allocating than ticking. every row of a board is a single
+// 64-bit word, and row y of every board is stored next to row y of the others (structure of arrays), so a tick walks
+// all boards in lockstep. boards that settle into a still life or an oscillator stop being ticked.
+
+// default number of generations each board remembers the hash of, the longest period a batch detects
+#define GOL_BATCH_HISTORY 32
+
+struct gol_batch {
+    size_t boards;
+    gol_pos rows, cols;
+    gol_boundary boundary;
+    struct gol_rule rule;
+    // generations ticked since gol_batch_init
+    uint64_t generation;
+
+    // the single allocation everything below points into, its size, and the allocator it came from
+    void *block;
+    size_t block_size;
+    struct gol_allocator allocator;
+    // row y of the board in slot s is word (y * boards + s), the next generation goes into 'next'
+    uint64_t *cells;
+    uint64_t *next;
+    // a dead row, above and below the boards with GOL_BOUNDARY_DEAD
+    uint64_t *zero;
+    // the board in every slot, and the slot of every board. the boards still running occupy slots [0, running)
+    size_t *board_of;
+    size_t *slot_of;
+    size_t running;
+    // the hashes of the last 'history' generations of every slot (entry g % history for generation g), the hash of
+    // the generation being computed, and the generation each slot's hashes start from
+    uint64_t *hashes;
+    uint64_t *hash;
+    uint64_t *start;
+    size_t history;
+    // every board's period once it settled (0 while it's running), and the generation its cycle started
+    uint64_t *period;
+    uint64_t *since;
+
+    // worker pool splitting the boards of a tick, NULL when ticking on the calling thread only
+    struct gol_pool *pool;
+};
+
+// initializes 'boards' empty boards of rows x cols cells (cols at most 64) in a single allocation
+// opts->rule, boundary, threads, pin and allocator apply like they do to gol_init_opts, opts->history is the longest period
+// detected (0 for GOL_BATCH_HISTORY). the other options don't apply to a batch, opts can be NULL for the defaults
+gol_err gol_batch_init(struct gol_batch *batch, size_t boards, gol_pos rows, gol_pos cols,
+                       const struct gol_options *opts);
+// releases the boards of the batch (except for the provided pointer itself)
+gol_err gol_batch_free(struct gol_batch *batch);
+// provides the bytes of memory the batch holds
+gol_err gol_batch_memory(const struct gol_batch *batch, size_t *bytes);
+// reads the cell at column x, row y of a board into 'alive'
+gol_err gol_batch_getcell(const struct gol_batch *batch, size_t board, gol_pos x, gol_pos y, bool *alive);
+// sets the cell at column x, row y of a board, which starts running again if it had settled
+gol_err gol_batch_setcell(struct gol_batch *batch, size_t board, gol_pos x, gol_pos y, bool alive);
+// populates every board with random cells, board b getting the same cells gol_populate_seeded gives a board of the
+// same size for seed + b. every board starts running again
+gol_err gol_batch_populate_seeded(struct gol_batch *batch, uint64_t seed, double density);
+// replaces a board with the top left rows x cols cells of 'game', which starts running again
+gol_err gol_batch_load(struct gol_batch *batch, size_t board, const struct gameoflife *game);
+// writes a board into the top left rows x cols cells of 'game'
+gol_err gol_batch_export(const struct gol_batch *batch, size_t board, struct gameoflife *game);
+// provides the number of live cells of a board
+gol_err gol_batch_population(const struct gol_batch *batch, size_t board, uint64_t *population);
+// provides the period of a board once it settled (1 for a still life, 0 while it's still running), and the generation
+// its cycle started at. a settled board keeps the cells of generation since + period
+gol_err gol_batch_status(const struct gol_batch *batch, size_t board, uint64_t *period, uint64_t *since);
+// ticks every running board forward one generation
+gol_err gol_batch_tick(struct gol_batch *batch);
+// ticks the running boards forward up to n generations, stopping early once every board settled
+gol_err gol_batch_run(struct gol_batch *batch, unsigned long n);
+
+#endif //C_PLAYGROUND_GOL_BATCH_H
@@ -0,0 +1,353 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "gol.h"
+#include "gol_bench.h"
+#include "gol_pattern.h"
+
+// Benchmark of every engine over a fixed set of workloads, reporting cells per second, ns per cell and memory.
+// Every workload is built from a fixed seed, so results (including the final population) are comparable across
+// builds and releases. Pass --json for machine readable output.
+// --record FILE writes the cells per second of every result to a file, which a later run given --baseline FILE fails
+// against if any result got slower by more than --threshold (a fraction, 0.25 by default), or has no baseline at all.
+// --threads 1 and --no-gpu leave out the engines whose results depend on the machine's cores and devices, as the
+// gol_throughput test of CMakeLists.txt does, against a baseline recorded on the machine it runs on (see
+// GOL_BENCH_BASELINE). whether the engines are right is checked by gol_test, with nothing timed.
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#define BENCH_POSIX
+#endif
+
+// a board to run every engine on
+struct bench_workload {
+    const char *name;
+    gol_pos size;
+    // fills the (packed, square) board
+    gol_err (*build)(struct gameoflife *game, const struct bench_workload *workload);
+    uint64_t seed;
+    // only run without --quick
+    bool slow;
+};
+
+// settings from the command line
+struct bench_settings {
+    bool json;
+    bool quick;
+    double min_time;
+    unsigned int threads;
+    const char *filter;
+    // whether a board can tick on a gpu here (see GOL_BACKEND_GPU), and it wasn't turned off with --no-gpu
+    bool gpu;
+    // how the threads of the threaded engine are pinned
+    gol_pinning pin;
+    // baseline to fail against and how much slower than it a result may be, and where to record the results
+    const char *baseline;
+    double threshold;
+    const char *record;
+};
+
+// the wall clock in seconds
+static double bench_now(void) {
+#ifdef BENCH_POSIX
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+#else
+    return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// the most memory the process has held at once
+static size_t bench_peak_rss(void) {
+#ifdef BENCH_POSIX
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+static unsigned int bench_cores(void) {
+#ifdef BENCH_POSIX
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (unsigned int) cores : 1;
+#else
+    return 1;
+#endif
+}
+
+// workloads
+
+static gol_err bench_random(struct gameoflife *game, const struct bench_workload *workload) {
+    return gol_populate_seeded(game, workload->seed, 0.5);
+}
+
+static gol_err bench_guns(struct gameoflife *game, const struct bench_workload *workload) {
+    gol_err error;
+    (void) workload;
+    FILE *file = tmpfile();
+    if (file == NULL) return GOL_ERR_IO;
+    fputs(bench_gun, file);
+    for (gol_pos y = 8; y + 9 < game->rows; y += 128) {
+        for (gol_pos x = 8; x + 36 < game->cols; x += 128) {
+            rewind(file);
+            if ((error = gol_pattern_readrle(game, file, x, y)) != GOL_ERR_OK) {
+                fclose(file);
+                return error;
+            }
+        }
+    }
+    fclose(file);
+    return GOL_ERR_OK;
+}
+
+static gol_err bench_ash(struct gameoflife *game, const struct bench_workload *workload) {
+    gol_err error;
+    if ((error = gol_populate_seeded(game, workload->seed, 0.5)) != GOL_ERR_OK) return error;
+    // a random soup settles into still lifes and oscillators after a few thousand generations
+    return gol_tick_n(game, 2000);
+}
+
+static const struct bench_workload bench_workloads[] = {
+        {"random50-256",  256,  bench_random, 1, false},
+        {"random50-1024", 1024, bench_random, 2, false},
+        {"random50-4096", 4096, bench_random, 3, true},
+        {"guns-1024",     1024, bench_guns,   0, false},
+        {"ash-1024",      1024, bench_ash,    4, false},
+};
+
+// timing
+
+// the result of one engine on one workload
+struct bench_result {
+    uint64_t generations;
+    double seconds;
+    size_t bytes;
+    uint64_t population;
+};
+
+// advances the engine a doubling number of generations until it has run for the minimum time
+static gol_err bench_measure(const struct bench_engine *engine, const struct gameoflife *board,
+                             const struct bench_settings *settings, struct bench_result *result) {
+    gol_err error;
+    struct bench_run run;
+    memset(&run, 0, sizeof(run));
+    if ((error = engine->setup(&run, board, settings->threads, settings->pin)) != GOL_ERR_OK) {
+        engine->release(&run);
+        return error;
+    }
+
+    memset(result, 0, sizeof(*result));
+    for (uint64_t n = 1; result->seconds < settings->min_time; n *= 2) {
+        double start = bench_now();
+        if ((error = engine->advance(&run, n)) != GOL_ERR_OK) break;
+        result->seconds += bench_now() - start;
+        result->generations += n;
+    }
+    if (error == GOL_ERR_OK) engine->report(&run, &result->bytes, &result->population);
+    engine->release(&run);
+    return error;
+}
+
+// performance baselines
+
+// most results a baseline holds
+#define BENCH_BASELINE_MAX 256
+
+// the cells per second of every result of an earlier run, by workload/engine
+struct bench_baseline {
+    char names[BENCH_BASELINE_MAX][64];
+    double cells_per_second[BENCH_BASELINE_MAX];
+    size_t count;
+};
+
+// reads a baseline written by --record, a line of a name and its cells per second for every result. fails rather than
+// leave anything out: on a line that isn't a name and a positive number, on more than BENCH_BASELINE_MAX lines, and on
+// a file with no lines at all
+static bool bench_readbaseline(struct bench_baseline *baseline, const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) return false;
+    baseline->count = 0;
+    bool ok = true;
+    for (;;) {
+        char name[64];
+        double cells_per_second;
+        int fields = fscanf(file, "%63s %lf", name, &cells_per_second);
+        if (fields == EOF) break;
+        if (fields != 2 || !(cells_per_second > 0) || baseline->count == BENCH_BASELINE_MAX) {
+            ok = false;
+            break;
+        }
+        strcpy(baseline->names[baseline->count], name);
+        baseline->cells_per_second[baseline->count++] = cells_per_second;
+    }
+    if (ferror(file) || baseline->count == 0) ok = false;
+    fclose(file);
+    return ok;
+}
+
+// looks up the cells per second the baseline holds for a result
+// Returns: Whether the baseline has the result
+static bool bench_lookup(const struct bench_baseline *baseline, const char *name, double *cells_per_second) {
+    for (size_t i = 0; i < baseline->count; i++) {
+        if (strcmp(baseline->names[i], name) == 0) {
+            *cells_per_second = baseline->cells_per_second[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void bench_usage(const char *name) {
+    fprintf(stderr, "usage: %s [--json] [--quick] [--time SECONDS] [--kernel NAME] [--threads N]\n"
+                    "       [--pin none|cores|nodes] [--filter TEXT] [--no-gpu]\n"
+                    "       [--record FILE] [--baseline FILE] [--threshold FRACTION]\n", name);
+}
+
+int main(int argc, char **argv) {
+    struct bench_settings settings = {false, false, 0.5, bench_cores(), NULL, bench_hasgpu(), GOL_PIN_NONE, NULL, 0.25,
+                                      NULL};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            settings.json = true;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            settings.quick = true;
+            settings.min_time = 0.05;
+        } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+            settings.min_time = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            if (gol_setkernel(argv[++i]) != GOL_ERR_OK) {
+                fprintf(stderr, "unknown or unsupported kernel: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.threads = (unsigned int) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "none") == 0) settings.pin = GOL_PIN_NONE;
+            else if (strcmp(argv[i], "cores") == 0) settings.pin = GOL_PIN_CORES;
+            else if (strcmp(argv[i], "nodes") == 0) settings.pin = GOL_PIN_NODES;
+            else {
+                bench_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            settings.filter = argv[++i];
+        } else if (strcmp(argv[i], "--no-gpu") == 0) {
+            settings.gpu = false;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            settings.record = argv[++i];
+        } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            settings.baseline = argv[++i];
+        } else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            settings.threshold = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "--help") == 0) {
+            bench_usage(argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            bench_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    static struct bench_baseline baseline;
+    if (settings.baseline != NULL && !bench_readbaseline(&baseline, settings.baseline)) {
+        fprintf(stderr, "couldn't read the baseline %s, or it's malformed or empty\n", settings.baseline);
+        return EXIT_FAILURE;
+    }
+    FILE *record = NULL;
+    if (settings.record != NULL && (record = fopen(settings.record, "w")) == NULL) {
+        fprintf(stderr, "couldn't create %s\n", settings.record);
+        return EXIT_FAILURE;
+    }
+
+    if (settings.json)
+        printf("{\n  \"kernel\": \"%s\",\n  \"threads\": %u,\n  \"results\": [", gol_kernelname(), settings.threads);
+    else
+        printf("kernel %s, %u threads\n%-14s %-15s %12s %12s %10s %12s %12s\n", gol_kernelname(), settings.threads,
+               "workload", "engine", "generations", "cells/s", "ns/cell", "memory KiB", "population");
+
+    bool first = true;
+    int failures = 0;
+    for (size_t w = 0; w < sizeof(bench_workloads) / sizeof(bench_workloads[0]); w++) {
+        const struct bench_workload *workload = &bench_workloads[w];
+        if (workload->slow && settings.quick) continue;
+
+        // the board every engine starts from
+        struct gameoflife board;
+        struct gol_options opts = {0};
+        opts.storage = GOL_STORAGE_PACKED;
+        if (gol_init_opts(&board, workload->size, workload->size, &opts) != GOL_ERR_OK ||
+            workload->build(&board, workload) != GOL_ERR_OK) {
+            fprintf(stderr, "%s: couldn't build the board\n", workload->name);
+            gol_free(&board);
+            failures++;
+            continue;
+        }
+        board.generation = 0;
+
+        for (size_t e = 0; e < bench_engine_count; e++) {
+            const struct bench_engine *engine = &bench_engines[e];
+            char name[64];
+            snprintf(name, sizeof(name), "%s/%s", workload->name, engine->name);
+            if (settings.filter != NULL && strstr(name, settings.filter) == NULL) continue;
+            if (engine->threaded && settings.threads < 2) continue;
+            if (engine->gpu && !settings.gpu) continue;
+
+            struct bench_result result;
+            gol_err error = bench_measure(engine, &board, &settings, &result);
+            if (error != GOL_ERR_OK) {
+                fprintf(stderr, "%s: failed with error %u\n", name, error);
+                failures++;
+                continue;
+            }
+            double cells = (double) workload->size * (double) workload->size * (double) result.generations;
+            if (settings.json) {
+                printf("%s\n    {\"workload\": \"%s\", \"engine\": \"%s\", \"rows\": %lld, \"cols\": %lld, "
+                       "\"generations\": %llu, \"seconds\": %.6f, \"cells_per_second\": %.6g, \"ns_per_cell\": %.6g, "
+                       "\"memory_bytes\": %llu, \"population\": %llu}", first ? "" : ",", workload->name,
+                       engine->name, (long long) workload->size, (long long) workload->size,
+                       (unsigned long long) result.generations, result.seconds, cells / result.seconds,
+                       result.seconds * 1e9 / cells, (unsigned long long) result.bytes,
+                       (unsigned long long) result.population);
+            } else {
+                printf("%-14s %-15s %12llu %12.4g %10.4g %12.0f %12llu\n", workload->name, engine->name,
+                       (unsigned long long) result.generations, cells / result.seconds, result.seconds * 1e9 / cells,
+                       (double) result.bytes / 1024.0, (unsigned long long) result.population);
+            }
+            fflush(stdout);
+            first = false;
+
+            double cells_per_second = cells / result.seconds, expected;
+            if (record != NULL) fprintf(record, "%s %.6g\n", name, cells_per_second);
+            if (settings.baseline == NULL) continue;
+            if (!bench_lookup(&baseline, name, &expected)) {
+                fprintf(stderr, "%s: not in the baseline %s\n", name, settings.baseline);
+                failures++;
+            } else if (cells_per_second < expected * (1.0 - settings.threshold)) {
+                fprintf(stderr, "%s: %.4g cells/s is more than %.0f%% below the baseline of %.4g\n", name,
+                        cells_per_second, settings.threshold * 100.0, expected);
+                failures++;
+            }
+        }
+        gol_free(&board);
+    }
+    if (record != NULL && fclose(record) != 0) {
+        fprintf(stderr, "couldn't write %s\n", settings.record);
+        failures++;
+    }
+
+    if (settings.json)
+        printf("\n  ],\n  \"peak_rss_bytes\": %llu\n}\n", (unsigned long long) bench_peak_rss());
+    else
+        printf("peak memory %.1fM\n", (double) bench_peak_rss() / (1024.0 * 1024.0));
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+#ifndef C_PLAYGROUND_GOL_BENCH_H
+#define C_PLAYGROUND_GOL_BENCH_H
+
+// PRIVATE
+// The engines gol_bench times and gol_test checks, each behind the same few calls so both can run all of them over
+// any board. Not part of the library.
+
+#include "gol.h"
+#include "gol_hashlife.h"
+#include "gol_sparse.h"
+
+// an engine being run, set up from a board
+struct bench_run {
+    struct gameoflife game;
+    struct gol_hashlife hl;
+    struct gol_sparse sparse;
+    // the part of the universe of hashlife or sparse covered by the board, exported by 'cells'
+    struct gameoflife window;
+};
+
+struct bench_engine {
+    const char *name;
+    // set up the engine with the board, advance it n generations (a power of two when timed), report on it and free it
+    // only the threaded engine uses the threads and their pinning
+    gol_err (*setup)(struct bench_run *run, const struct gameoflife *board, unsigned int threads, gol_pinning pin);
+    gol_err (*advance)(struct bench_run *run, uint64_t n);
+    void (*report)(const struct bench_run *run, size_t *bytes, uint64_t *population);
+    void (*release)(struct bench_run *run);
+    // provides the cells the engine is at as a board the size of the one it was set up with
+    gol_err (*cells)(struct bench_run *run, const struct gameoflife *board, const struct gameoflife **cells);
+    // whether the engine runs on the game's worker threads, or on a gpu
+    bool threaded;
+    bool gpu;
+    // whether the engine has no edges, so patterns reaching the edges of the board end up elsewhere than on it
+    bool unbounded;
+};
+
+// the classic gosper glider gun, as RLE
+extern const char bench_gun[];
+
+// every engine, in the order they are run
+extern const struct bench_engine bench_engines[];
+extern const size_t bench_engine_count;
+
+// copies the board into a game with the provided settings, through a snapshot so any storage can be used
+gol_err bench_load(struct gameoflife *game, const struct gameoflife *board, const struct gol_options *opts);
+// whether a board asking for the gpu gets one, or ticks on the cpu anyway
+bool bench_hasgpu(void);
+
+#endif //C_PLAYGROUND_GOL_BENCH_H
@@ -0,0 +1,204 @@
+#include "gol_bench.h"
+#include "gol_hashlife.h"
+#include "gol_snapshot.h"
+#include "gol_sparse.h"
+
+#include <stdio.h>
+#include <string.h>
+
+const char bench_gun[] =
+        "x = 36, y = 9, rule = B3/S23\n"
+        "24bo$22bobo$12b2o6b2o12b2o$11bo3bo4b2o12b2o$2o8bo5bo3b2o$2o8bo3bob2o4b\n"
+        "obo$10bo5bo7bo$11bo3bo$12b2o!\n";
+
+// whether a board asking for the gpu gets one, or ticks on the cpu anyway
+bool bench_hasgpu(void) {
+    struct gameoflife game;
+    struct gol_options opts = {0};
+    opts.storage = GOL_STORAGE_PACKED;
+    opts.backend = GOL_BACKEND_GPU;
+    if (gol_init_opts(&game, 64, 64, &opts) != GOL_ERR_OK) return false;
+    bool gpu = strcmp(gol_backendname(&game), "cpu") != 0;
+    gol_free(&game);
+    return gpu;
+}
+
+// copies the board into a game with the provided settings, through a snapshot so any storage can be used
+gol_err bench_load(struct gameoflife *game, const struct gameoflife *board, const struct gol_options *opts) {
+    gol_err error;
+    FILE *file = tmpfile();
+    if (file == NULL) return GOL_ERR_IO;
+    if ((error = gol_snapshot_write(board, file, 0)) == GOL_ERR_OK) {
+        rewind(file);
+        error = gol_snapshot_read(game, file, opts);
+    }
+    fclose(file);
+    return error;
+}
+
+static gol_err bench_setup_game(struct bench_run *run, const struct gameoflife *board, gol_storage storage,
+                                unsigned int threads, gol_pinning pin, bool tiles, gol_backend backend) {
+    struct gol_options opts = {0};
+    opts.storage = storage;
+    opts.threads = threads;
+    opts.pin = pin;
+    opts.tiles = tiles;
+    opts.backend = backend;
+    return bench_load(&run->game, board, &opts);
+}
+
+static gol_err bench_setup_bytes(struct bench_run *run, const struct gameoflife *board,
+                                 unsigned int threads, gol_pinning pin) {
+    (void) threads;
+    (void) pin;
+    return bench_setup_game(run, board, GOL_STORAGE_BYTES, 0, GOL_PIN_NONE, false, GOL_BACKEND_CPU);
+}
+
+static gol_err bench_setup_packed(struct bench_run *run, const struct gameoflife *board,
+                                  unsigned int threads, gol_pinning pin) {
+    (void) threads;
+    (void) pin;
+    return bench_setup_game(run, board, GOL_STORAGE_PACKED, 0, GOL_PIN_NONE, false, GOL_BACKEND_CPU);
+}
+
+static gol_err bench_setup_tiles(struct bench_run *run, const struct gameoflife *board,
+                                 unsigned int threads, gol_pinning pin) {
+    (void) threads;
+    (void) pin;
+    return bench_setup_game(run, board, GOL_STORAGE_PACKED, 0, GOL_PIN_NONE, true, GOL_BACKEND_CPU);
+}
+
+static gol_err bench_setup_threads(struct bench_run *run, const struct gameoflife *board,
+                                   unsigned int threads, gol_pinning pin) {
+    return bench_setup_game(run, board, GOL_STORAGE_PACKED, threads, pin, false, GOL_BACKEND_CPU);
+}
+
+static gol_err bench_setup_gpu(struct bench_run *run, const struct gameoflife *board,
+                               unsigned int threads, gol_pinning pin) {
+    (void) threads;
+    (void) pin;
+    return bench_setup_game(run, board, GOL_STORAGE_PACKED, 0, GOL_PIN_NONE, false, GOL_BACKEND_GPU);
+}
+
+static gol_err bench_tick(struct bench_run *run, uint64_t n) {
+    gol_err error;
+    for (uint64_t i = 0; i < n; i++) {
+        if ((error = gol_tick(&run->game)) != GOL_ERR_OK) return error;
+    }
+    return GOL_ERR_OK;
+}
+
+static gol_err bench_tick_n(struct bench_run *run, uint64_t n) {
+    return gol_tick_n(&run->game, (unsigned long) n);
+}
+
+static void bench_report_game(const struct bench_run *run, size_t *bytes, uint64_t *population) {
+    gol_memory(&run->game, bytes);
+    gol_population(&run->game, population);
+}
+
+static void bench_release_game(struct bench_run *run) {
+    gol_free(&run->game);
+}
+
+static gol_err bench_cells_game(struct bench_run *run, const struct gameoflife *board,
+                                const struct gameoflife **cells) {
+    (void) board;
+    *cells = &run->game;
+    return GOL_ERR_OK;
+}
+
+// sets up the board the cells of an unbounded engine are exported into
+static gol_err bench_window(struct bench_run *run, const struct gameoflife *board) {
+    struct gol_options opts = {0};
+    opts.storage = GOL_STORAGE_PACKED;
+    gol_free(&run->window);
+    return gol_init_opts(&run->window, board->rows, board->cols, &opts);
+}
+
+static gol_err bench_setup_hashlife(struct bench_run *run, const struct gameoflife *board,
+                                    unsigned int threads, gol_pinning pin) {
+    gol_err error;
+    (void) threads;
+    (void) pin;
+    if ((error = gol_hashlife_init(&run->hl, 0, NULL)) != GOL_ERR_OK) return error;
+    return gol_hashlife_load(&run->hl, board);
+}
+
+// steps the universe a power of two generations at a time, a single step when n is one
+static gol_err bench_advance_hashlife(struct bench_run *run, uint64_t n) {
+    gol_err error;
+    for (unsigned int k = 0; k < 64 && (n >> k) != 0; k++) {
+        if (((n >> k) & 1) && (error = gol_hashlife_step(&run->hl, k)) != GOL_ERR_OK) return error;
+    }
+    return GOL_ERR_OK;
+}
+
+static void bench_report_hashlife(const struct bench_run *run, size_t *bytes, uint64_t *population) {
+    gol_hashlife_memory(&run->hl, bytes);
+    gol_hashlife_population(&run->hl, population);
+}
+
+static void bench_release_hashlife(struct bench_run *run) {
+    gol_hashlife_free(&run->hl);
+    gol_free(&run->window);
+}
+
+static gol_err bench_cells_hashlife(struct bench_run *run, const struct gameoflife *board,
+                                    const struct gameoflife **cells) {
+    gol_err error;
+    if ((error = bench_window(run, board)) != GOL_ERR_OK) return error;
+    if ((error = gol_hashlife_export(&run->hl, &run->window)) != GOL_ERR_OK) return error;
+    *cells = &run->window;
+    return GOL_ERR_OK;
+}
+
+static gol_err bench_setup_sparse(struct bench_run *run, const struct gameoflife *board,
+                                  unsigned int threads, gol_pinning pin) {
+    gol_err error;
+    (void) threads;
+    (void) pin;
+    if ((error = gol_sparse_init(&run->sparse, NULL)) != GOL_ERR_OK) return error;
+    return gol_sparse_load(&run->sparse, board, 0, 0);
+}
+
+static gol_err bench_advance_sparse(struct bench_run *run, uint64_t n) {
+    gol_err error;
+    for (uint64_t i = 0; i < n; i++) {
+        if ((error = gol_sparse_tick(&run->sparse)) != GOL_ERR_OK) return error;
+    }
+    return GOL_ERR_OK;
+}
+
+static void bench_report_sparse(const struct bench_run *run, size_t *bytes, uint64_t *population) {
+    gol_sparse_memory(&run->sparse, bytes);
+    *population = run->sparse.population;
+}
+
+static void bench_release_sparse(struct bench_run *run) {
+    gol_sparse_free(&run->sparse);
+    gol_free(&run->window);
+}
+
+static gol_err bench_cells_sparse(struct bench_run *run, const struct gameoflife *board,
+                                  const struct gameoflife **cells) {
+    gol_err error;
+    if ((error = bench_window(run, board)) != GOL_ERR_OK) return error;
+    if ((error = gol_sparse_export(&run->sparse, &run->window, 0, 0)) != GOL_ERR_OK) return error;
+    *cells = &run->window;
+    return GOL_ERR_OK;
+}
+
+// hashlife and sparse boards are unbounded, so their populations differ from the others once patterns reach the edges
+const struct bench_engine bench_engines[] = {
+        {"bytes",          bench_setup_bytes,    bench_tick,             bench_report_game,     bench_release_game,     bench_cells_game,     false, false, false},
+        {"packed",         bench_setup_packed,   bench_tick,             bench_report_game,     bench_release_game,     bench_cells_game,     false, false, false},
+        {"packed-tiles",   bench_setup_tiles,    bench_tick,             bench_report_game,     bench_release_game,     bench_cells_game,     false, false, false},
+        {"packed-threads", bench_setup_threads,  bench_tick,             bench_report_game,     bench_release_game,     bench_cells_game,     true,  false, false},
+        {"packed-tick_n",  bench_setup_packed,   bench_tick_n,           bench_report_game,     bench_release_game,     bench_cells_game,     false, false, false},
+        {"gpu",            bench_setup_gpu,      bench_tick_n,           bench_report_game,     bench_release_game,     bench_cells_game,     false, true,  false},
+        {"hashlife",       bench_setup_hashlife, bench_advance_hashlife, bench_report_hashlife, bench_release_hashlife, bench_cells_hashlife, false, false, true},
+        {"sparse",         bench_setup_sparse,   bench_advance_sparse,   bench_report_sparse,   bench_release_sparse,   bench_cells_sparse,   false, false, true},
+};
+
+const size_t bench_engine_count = sizeof(bench_engines) / sizeof(bench_engines[0]);
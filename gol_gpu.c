@@ -0,0 +1,360 @@
+#include "gol_gpu.h"
+#include "gol_alloc.h"
+
+#include <string.h>
+
+#if defined(_WIN32)
+#define GOL_GPU_OPENCL
+#include <windows.h>
+#define GOL_CL_CALL __stdcall
+#elif defined(__unix__) || defined(__APPLE__)
+#define GOL_GPU_OPENCL
+#include <dlfcn.h>
+#define GOL_CL_CALL
+#endif
+
+#ifdef GOL_GPU_OPENCL
+
+// the few types and constants of the OpenCL 1.2 api used below, so the headers aren't needed to build
+typedef int32_t cl_int;
+typedef uint32_t cl_uint;
+typedef int64_t cl_long;
+typedef uint64_t cl_bitfield;
+typedef intptr_t cl_context_properties;
+typedef struct _cl_platform_id *cl_platform_id;
+typedef struct _cl_device_id *cl_device_id;
+typedef struct _cl_context *cl_context;
+typedef struct _cl_command_queue *cl_command_queue;
+typedef struct _cl_mem *cl_mem;
+typedef struct _cl_program *cl_program;
+typedef struct _cl_kernel *cl_kernel;
+typedef struct _cl_event *cl_event;
+
+#define GOL_CL_SUCCESS 0
+#define GOL_CL_TRUE 1
+#define GOL_CL_DEVICE_TYPE_GPU ((cl_bitfield)1 << 2)
+#define GOL_CL_DEVICE_TYPE_ACCELERATOR ((cl_bitfield)1 << 3)
+#define GOL_CL_DEVICE_NAME 0x102B
+#define GOL_CL_MEM_READ_WRITE ((cl_bitfield)1 << 0)
+
+// the OpenCL functions, looked up in the library by their names (with a "cl" prefix)
+struct gol_cl {
+    cl_int (GOL_CL_CALL *GetPlatformIDs)(cl_uint, cl_platform_id *, cl_uint *);
+    cl_int (GOL_CL_CALL *GetDeviceIDs)(cl_platform_id, cl_bitfield, cl_uint, cl_device_id *, cl_uint *);
+    cl_int (GOL_CL_CALL *GetDeviceInfo)(cl_device_id, cl_uint, size_t, void *, size_t *);
+    cl_context (GOL_CL_CALL *CreateContext)(const cl_context_properties *, cl_uint, const cl_device_id *,
+                                            void (GOL_CL_CALL *)(const char *, const void *, size_t, void *), void *,
+                                            cl_int *);
+    cl_command_queue (GOL_CL_CALL *CreateCommandQueue)(cl_context, cl_device_id, cl_bitfield, cl_int *);
+    cl_program (GOL_CL_CALL *CreateProgramWithSource)(cl_context, cl_uint, const char **, const size_t *, cl_int *);
+    cl_int (GOL_CL_CALL *BuildProgram)(cl_program, cl_uint, const cl_device_id *, const char *,
+                                       void (GOL_CL_CALL *)(cl_program, void *), void *);
+    cl_kernel (GOL_CL_CALL *CreateKernel)(cl_program, const char *, cl_int *);
+    cl_mem (GOL_CL_CALL *CreateBuffer)(cl_context, cl_bitfield, size_t, void *, cl_int *);
+    cl_int (GOL_CL_CALL *SetKernelArg)(cl_kernel, cl_uint, size_t, const void *);
+    cl_int (GOL_CL_CALL *EnqueueNDRangeKernel)(cl_command_queue, cl_kernel, cl_uint, const size_t *, const size_t *,
+                                               const size_t *, cl_uint, const cl_event *, cl_event *);
+    cl_int (GOL_CL_CALL *EnqueueReadBuffer)(cl_command_queue, cl_mem, cl_uint, size_t, size_t, void *, cl_uint,
+                                            const cl_event *, cl_event *);
+    cl_int (GOL_CL_CALL *EnqueueWriteBuffer)(cl_command_queue, cl_mem, cl_uint, size_t, size_t, const void *, cl_uint,
+                                             const cl_event *, cl_event *);
+    cl_int (GOL_CL_CALL *Finish)(cl_command_queue);
+    cl_int (GOL_CL_CALL *ReleaseMemObject)(cl_mem);
+    cl_int (GOL_CL_CALL *ReleaseKernel)(cl_kernel);
+    cl_int (GOL_CL_CALL *ReleaseProgram)(cl_program);
+    cl_int (GOL_CL_CALL *ReleaseCommandQueue)(cl_command_queue);
+    cl_int (GOL_CL_CALL *ReleaseContext)(cl_context);
+};
+
+// the names of the functions of struct gol_cl, in the same order
+static const char *const gol_cl_names[] = {
+        "clGetPlatformIDs", "clGetDeviceIDs", "clGetDeviceInfo", "clCreateContext", "clCreateCommandQueue",
+        "clCreateProgramWithSource", "clBuildProgram", "clCreateKernel", "clCreateBuffer", "clSetKernelArg",
+        "clEnqueueNDRangeKernel", "clEnqueueReadBuffer", "clEnqueueWriteBuffer", "clFinish", "clReleaseMemObject",
+        "clReleaseKernel", "clReleaseProgram", "clReleaseCommandQueue", "clReleaseContext"
+};
+
+// The tick as an OpenCL kernel, one work item per word of the packed board
+// Every word is ticked like gol_wordrule does, the cells beyond its west and east ends are read one at a time from the
+// neighboring words, or across the edge of the board for its boundary, so the first and last words need no special case
+static const char gol_gpu_source[] =
+        "ulong gol_edge(__global const ulong *row, long cols, uint boundary, long x) {\n"
+        "    if (x < 0 || x >= cols) {\n"
+        "        if (boundary == 0) return 0;\n"
+        "        if (boundary == 1) x = x < 0 ? x + cols : x - cols;\n"
+        "        else x = x < 0 ? 0 : cols - 1;\n"
+        "    }\n"
+        "    return (row[x / 64] >> (x % 64)) & 1;\n"
+        "}\n"
+        "ulong gol_counts(uint counts, ulong ones, ulong twos, ulong fours, ulong eights) {\n"
+        "    ulong cells = 0;\n"
+        "    for (uint n = 0; n <= 8; n++) {\n"
+        "        if (!((counts >> n) & 1)) continue;\n"
+        "        cells |= (n & 1 ? ones : ~ones) & (n & 2 ? twos : ~twos) & (n & 4 ? fours : ~fours)\n"
+        "                 & (n & 8 ? eights : ~eights);\n"
+        "    }\n"
+        "    return cells;\n"
+        "}\n"
+        "__kernel void gol_tick(__global const ulong *board, __global ulong *next, long words, long rows, long cols,\n"
+        "                       uint boundary, uint birth, uint survive) {\n"
+        "    long w = get_global_id(0), y = get_global_id(1);\n"
+        "    if (w >= words || y >= rows) return;\n"
+        "    long x0 = w * 64, n = cols - x0 < 64 ? cols - x0 : 64;\n"
+        "    ulong west[3], mid[3], east[3];\n"
+        "    for (int i = 0; i < 3; i++) {\n"
+        "        long r = y + i - 1;\n"
+        "        west[i] = mid[i] = east[i] = 0;\n"
+        "        if (r < 0 || r >= rows) {\n"
+        "            if (boundary == 0) continue;\n"
+        "            if (boundary == 1) r = r < 0 ? r + rows : r - rows;\n"
+        "            else r = r < 0 ? 0 : rows - 1;\n"
+        "        }\n"
+        "        __global const ulong *row = board + r * words;\n"
+        "        mid[i] = row[w];\n"
+        "        west[i] = (mid[i] << 1) | gol_edge(row, cols, boundary, x0 - 1);\n"
+        "        east[i] = (mid[i] >> 1) | (gol_edge(row, cols, boundary, x0 + n) << (n - 1));\n"
+        "    }\n"
+        "    ulong us = west[0] ^ mid[0] ^ east[0], uk = (west[0] & mid[0]) | (east[0] & (west[0] ^ mid[0]));\n"
+        "    ulong ds = west[2] ^ mid[2] ^ east[2], dk = (west[2] & mid[2]) | (east[2] & (west[2] ^ mid[2]));\n"
+        "    ulong ms = west[1] ^ east[1], mk = west[1] & east[1];\n"
+        "    ulong ones = us ^ ms ^ ds, k = (us & ms) | (ds & (us ^ ms));\n"
+        "    ulong t = uk ^ mk ^ dk, tk = (uk & mk) | (dk & (uk ^ mk));\n"
+        "    ulong twos = t ^ k, fours = tk ^ (t & k), eights = tk & t & k;\n"
+        "    ulong cells = (mid[1] & gol_counts(survive, ones, twos, fours, eights))\n"
+        "                  | (~mid[1] & gol_counts(birth, ones, twos, fours, eights));\n"
+        "    next[y * words + w] = n == 64 ? cells : cells & (((ulong)1 << n) - 1);\n"
+        "}\n";
+
+struct gol_gpu {
+    void *library;
+    struct gol_cl cl;
+    cl_context context;
+    cl_command_queue queue;
+    cl_program program;
+    cl_kernel kernel;
+    // the current generation and the back buffer, swapped every generation like the ones in host memory
+    cl_mem buffers[2];
+    size_t size;
+    char name[128];
+    // whether the device holds a later generation than host memory, or host memory was written since the upload
+    bool device_newer;
+    bool host_newer;
+    // the allocator of the game, which this struct itself comes from
+    struct gol_allocator allocator;
+};
+
+// PRIVATE
+// Loads the OpenCL library of the system and looks up every function of struct gol_cl in it
+// Returns: Whether all of them were found
+static bool gol_gpu_load(struct gol_gpu *gpu) {
+#if defined(_WIN32)
+    HMODULE library = LoadLibraryA("OpenCL.dll");
+    if (library == NULL) return false;
+    gpu->library = (void *) library;
+#else
+    const char *names[] = {"libOpenCL.so.1", "libOpenCL.so", "/System/Library/Frameworks/OpenCL.framework/OpenCL"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]) && gpu->library == NULL; i++)
+        gpu->library = dlopen(names[i], RTLD_NOW | RTLD_LOCAL);
+    if (gpu->library == NULL) return false;
+#endif
+
+    // struct gol_cl is nothing but function pointers, in the order of gol_cl_names
+    void (**functions)(void) = (void (**)(void)) &gpu->cl;
+    for (size_t i = 0; i < sizeof(gol_cl_names) / sizeof(gol_cl_names[0]); i++) {
+#if defined(_WIN32)
+        functions[i] = (void (*)(void)) GetProcAddress((HMODULE) gpu->library, gol_cl_names[i]);
+#else
+        // converting the object pointer of dlsym to a function pointer, which posix allows
+        *(void **) &functions[i] = dlsym(gpu->library, gol_cl_names[i]);
+#endif
+        if (functions[i] == NULL) return false;
+    }
+    return true;
+}
+
+// Opens the first gpu (or accelerator) of any OpenCL platform, builds the tick kernel for it and allocates the board,
+// the host side state comes from the game's allocator
+// Possible errors (return value): GOL_ERR_INIT (no OpenCL, no device or the kernel didn't build), GOL_ERR_NOMEM,
+// GOL_ERR_OK
+gol_err gol_gpu_create(struct gol_gpu **result, const struct gameoflife *game) {
+    struct gol_gpu *gpu = (struct gol_gpu *) gol_zalloc(&game->allocator, 1, sizeof(struct gol_gpu));
+    if (gpu == NULL) return GOL_ERR_NOMEM;
+    gpu->allocator = game->allocator;
+    if (!gol_gpu_load(gpu)) {
+        gol_gpu_destroy(gpu);
+        return GOL_ERR_INIT;
+    }
+
+    cl_platform_id platforms[16];
+    cl_uint count = 0;
+    cl_device_id device = NULL;
+    if (gpu->cl.GetPlatformIDs(16, platforms, &count) != GOL_CL_SUCCESS) count = 0;
+    for (cl_uint i = 0; i < count && i < 16 && device == NULL; i++) {
+        if (gpu->cl.GetDeviceIDs(platforms[i], GOL_CL_DEVICE_TYPE_GPU | GOL_CL_DEVICE_TYPE_ACCELERATOR, 1, &device,
+                                 NULL) != GOL_CL_SUCCESS)
+            device = NULL;
+    }
+    if (device == NULL) {
+        gol_gpu_destroy(gpu);
+        return GOL_ERR_INIT;
+    }
+    if (gpu->cl.GetDeviceInfo(device, GOL_CL_DEVICE_NAME, sizeof(gpu->name) - 1, gpu->name, NULL) != GOL_CL_SUCCESS)
+        strcpy(gpu->name, "opencl");
+
+    cl_int status;
+    gpu->context = gpu->cl.CreateContext(NULL, 1, &device, NULL, NULL, &status);
+    if (gpu->context != NULL) gpu->queue = gpu->cl.CreateCommandQueue(gpu->context, device, 0, &status);
+    if (gpu->queue != NULL) {
+        const char *source = gol_gpu_source;
+        gpu->program = gpu->cl.CreateProgramWithSource(gpu->context, 1, &source, NULL, &status);
+    }
+    if (gpu->program != NULL && gpu->cl.BuildProgram(gpu->program, 1, &device, "", NULL, NULL) == GOL_CL_SUCCESS)
+        gpu->kernel = gpu->cl.CreateKernel(gpu->program, "gol_tick", &status);
+    if (gpu->kernel == NULL) {
+        gol_gpu_destroy(gpu);
+        return GOL_ERR_INIT;
+    }
+
+    gpu->size = (size_t)game->rows * game->words * sizeof(uint64_t);
+    for (int i = 0; i < 2; i++) {
+        gpu->buffers[i] = gpu->cl.CreateBuffer(gpu->context, GOL_CL_MEM_READ_WRITE, gpu->size, NULL, &status);
+        if (gpu->buffers[i] == NULL) {
+            gol_gpu_destroy(gpu);
+            return GOL_ERR_NOMEM;
+        }
+    }
+    gpu->host_newer = true;
+    *result = gpu;
+    return GOL_ERR_OK;
+}
+
+void gol_gpu_destroy(struct gol_gpu *gpu) {
+    if (gpu == NULL) return;
+    for (int i = 0; i < 2; i++) {
+        if (gpu->buffers[i])
+            gpu->cl.ReleaseMemObject(gpu->buffers[i]);
+    }
+    if (gpu->kernel)
+        gpu->cl.ReleaseKernel(gpu->kernel);
+    if (gpu->program)
+        gpu->cl.ReleaseProgram(gpu->program);
+    if (gpu->queue)
+        gpu->cl.ReleaseCommandQueue(gpu->queue);
+    if (gpu->context)
+        gpu->cl.ReleaseContext(gpu->context);
+#if defined(_WIN32)
+    if (gpu->library)
+        FreeLibrary((HMODULE) gpu->library);
+#else
+    if (gpu->library)
+        dlclose(gpu->library);
+#endif
+    const struct gol_allocator allocator = gpu->allocator;
+    gol_dealloc(&allocator, gpu);
+}
+
+const char *gol_gpu_name(const struct gol_gpu *gpu) {
+    return gpu->name;
+}
+
+size_t gol_gpu_memory(const struct gol_gpu *gpu) {
+    return 2 * gpu->size;
+}
+
+void gol_gpu_hostchanged(struct gol_gpu *gpu) {
+    gpu->device_newer = false;
+    gpu->host_newer = true;
+}
+
+// Copies the current generation back into the packed board in host memory, if the device is ahead of it
+// Possible errors (return value): GOL_ERR_IO (the device failed), GOL_ERR_OK
+gol_err gol_gpu_sync(struct gol_gpu *gpu, const struct gameoflife *game) {
+    if (!gpu->device_newer) return GOL_ERR_OK;
+    if (gpu->cl.EnqueueReadBuffer(gpu->queue, gpu->buffers[0], GOL_CL_TRUE, 0, gpu->size, game->packed, 0, NULL,
+                                  NULL) != GOL_CL_SUCCESS)
+        return GOL_ERR_IO;
+    gpu->device_newer = false;
+    return GOL_ERR_OK;
+}
+
+// Ticks the board n generations on the device, which keeps it until it's asked for by gol_gpu_sync
+// The rule is passed on every call, so gol_setrule applies to the next tick like it does on the cpu
+// Possible errors (return value): GOL_ERR_IO (the device failed), GOL_ERR_OK
+gol_err gol_gpu_tick(struct gol_gpu *gpu, const struct gameoflife *game, unsigned long n) {
+    if (gpu->host_newer) {
+        if (gpu->cl.EnqueueWriteBuffer(gpu->queue, gpu->buffers[0], GOL_CL_TRUE, 0, gpu->size, game->packed, 0, NULL,
+                                       NULL) != GOL_CL_SUCCESS)
+            return GOL_ERR_IO;
+        gpu->host_newer = false;
+    }
+
+    const cl_long words = (cl_long)game->words, rows = game->rows, cols = game->cols;
+    const cl_uint boundary = game->boundary, birth = game->rule.birth, survive = game->rule.survive;
+    cl_int status = GOL_CL_SUCCESS;
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 2, sizeof(cl_long), &words);
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 3, sizeof(cl_long), &rows);
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 4, sizeof(cl_long), &cols);
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 5, sizeof(cl_uint), &boundary);
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 6, sizeof(cl_uint), &birth);
+    status |= gpu->cl.SetKernelArg(gpu->kernel, 7, sizeof(cl_uint), &survive);
+
+    const size_t global[2] = {game->words, (size_t)game->rows};
+    for (unsigned long i = 0; i < n && status == GOL_CL_SUCCESS; i++) {
+        status |= gpu->cl.SetKernelArg(gpu->kernel, 0, sizeof(cl_mem), &gpu->buffers[0]);
+        status |= gpu->cl.SetKernelArg(gpu->kernel, 1, sizeof(cl_mem), &gpu->buffers[1]);
+        status |= gpu->cl.EnqueueNDRangeKernel(gpu->queue, gpu->kernel, 2, NULL, global, NULL, 0, NULL, NULL);
+        cl_mem buffer = gpu->buffers[0];
+        gpu->buffers[0] = gpu->buffers[1];
+        gpu->buffers[1] = buffer;
+    }
+    // the generations are computed by the time the tick returns, like on the cpu
+    if (status == GOL_CL_SUCCESS) status = gpu->cl.Finish(gpu->queue);
+    if (status != GOL_CL_SUCCESS) return GOL_ERR_IO;
+    gpu->device_newer = true;
+    return GOL_ERR_OK;
+}
+
+#else
+
+// without a way to load OpenCL there is never a device, and the functions below are never called
+struct gol_gpu {
+    char name[1];
+};
+
+gol_err gol_gpu_create(struct gol_gpu **result, const struct gameoflife *game) {
+    (void) result;
+    (void) game;
+    return GOL_ERR_INIT;
+}
+
+void gol_gpu_destroy(struct gol_gpu *gpu) {
+    (void) gpu;
+}
+
+const char *gol_gpu_name(const struct gol_gpu *gpu) {
+    return gpu->name;
+}
+
+size_t gol_gpu_memory(const struct gol_gpu *gpu) {
+    (void) gpu;
+    return 0;
+}
+
+void gol_gpu_hostchanged(struct gol_gpu *gpu) {
+    (void) gpu;
+}
+
+gol_err gol_gpu_sync(struct gol_gpu *gpu, const struct gameoflife *game) {
+    (void) gpu;
+    (void) game;
+    return GOL_ERR_OK;
+}
+
+gol_err gol_gpu_tick(struct gol_gpu *gpu, const struct gameoflife *game, unsigned long n) {
+    (void) gpu;
+    (void) game;
+    (void) n;
+    return GOL_ERR_INIT;
+}
+
+#endif //GOL_GPU_OPENCL
@@ -0,0 +1,29 @@
+#ifndef C_PLAYGROUND_GOL_GPU_H
+#define C_PLAYGROUND_GOL_GPU_H
+
+// PRIVATE
+// OpenCL backend of gol_tick (see GOL_BACKEND_GPU), shared between gol.c and gol_gpu.c. Not part of the public API.
+// OpenCL is loaded when a device is opened, so there's nothing to link against and no device needed to build.
+
+#include "gol.h"
+
+struct gol_gpu;
+
+// opens the first gpu found and allocates both buffers of the packed board of 'game' on it, which start out older than
+// the board in host memory
+// fails with GOL_ERR_INIT without OpenCL or a device, and with GOL_ERR_NOMEM if the board doesn't fit the device
+gol_err gol_gpu_create(struct gol_gpu **gpu, const struct gameoflife *game);
+// releases the buffers on the device and closes it
+void gol_gpu_destroy(struct gol_gpu *gpu);
+// provides the name of the device
+const char *gol_gpu_name(const struct gol_gpu *gpu);
+// provides the bytes of device memory held by the board
+size_t gol_gpu_memory(const struct gol_gpu *gpu);
+// makes the board in host memory the current one, it's uploaded before the next tick
+void gol_gpu_hostchanged(struct gol_gpu *gpu);
+// copies the board back into host memory if the device holds a later generation of it
+gol_err gol_gpu_sync(struct gol_gpu *gpu, const struct gameoflife *game);
+// ticks the board n generations on the device, uploading it first if the host had changed it
+gol_err gol_gpu_tick(struct gol_gpu *gpu, const struct gameoflife *game, unsigned long n);
+
+#endif //C_PLAYGROUND_GOL_GPU_H
@@ -0,0 +1,571 @@
+#include "gol_hashlife.h"
+#include "gol_alloc.h"
+#include "gol_kernel.h"
+
+#include <string.h>
+
+// a square of 2^level x 2^level cells. level 0 nodes are single cells (the two leaves), every other node is made of four
+// children of the level below. nodes are unique for their children (hash-consed), so a node never changes once made
+struct gol_hlnode {
+    struct gol_hlnode *nw, *ne, *sw, *se;
+    // the center 2^(level-1) square, 2^min(step_log, level-2) generations later (NULL until it's computed)
+    struct gol_hlnode *result;
+    // next node in the same hash bucket (or in the freelist)
+    struct gol_hlnode *next;
+    uint64_t population;
+    unsigned int level;
+    bool marked;
+};
+
+// nodes are allocated in blocks to keep malloc out of the hot path
+#define GOL_HL_BLOCK 4096
+struct gol_hlblock {
+    struct gol_hlblock *next;
+    size_t used;
+    struct gol_hlnode nodes[GOL_HL_BLOCK];
+};
+
+// highest level a universe can grow to, so that coordinates and generation counts fit in 64 bits
+#define GOL_HL_MAXLEVEL 62
+
+// PRIVATE
+// Takes a node from the freelist or the current block, allocating a new block if both are exhausted
+// Returns: The zeroed node, or NULL if out of memory
+static struct gol_hlnode *gol_hl_alloc(struct gol_hashlife *hl) {
+    struct gol_hlnode *node = hl->freelist;
+    if (node != NULL) {
+        hl->freelist = node->next;
+    } else {
+        if (hl->blocks == NULL || hl->blocks->used == GOL_HL_BLOCK) {
+            struct gol_hlblock *block = (struct gol_hlblock *) gol_alloc(&hl->allocator, 1, sizeof(struct gol_hlblock));
+            if (block == NULL) return NULL;
+            block->used = 0;
+            block->next = hl->blocks;
+            hl->blocks = block;
+        }
+        node = &hl->blocks->nodes[hl->blocks->used++];
+    }
+    memset(node, 0, sizeof(struct gol_hlnode));
+    return node;
+}
+
+// PRIVATE
+// Hashes the four children of a node
+static inline size_t gol_hl_hash(const struct gol_hlnode *nw, const struct gol_hlnode *ne,
+                                 const struct gol_hlnode *sw, const struct gol_hlnode *se) {
+    uint64_t h = (uint64_t)(uintptr_t)nw * 0x9E3779B97F4A7C15ull;
+    h = (h ^ (h >> 29)) + (uint64_t)(uintptr_t)ne * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 31)) + (uint64_t)(uintptr_t)sw * 0x94D049BB133111EBull;
+    h = (h ^ (h >> 27)) + (uint64_t)(uintptr_t)se * 0xD6E8FEB86659FD93ull;
+    return (size_t)(h ^ (h >> 32));
+}
+
+// PRIVATE
+// Doubles the number of buckets of the hash table, if that fails the table just stays more crowded
+static void gol_hl_grow(struct gol_hashlife *hl) {
+    size_t buckets = hl->buckets * 2;
+    struct gol_hlnode **table = (struct gol_hlnode **) gol_zalloc(&hl->allocator, buckets, sizeof(struct gol_hlnode *));
+    if (table == NULL) return;
+
+    for (size_t i = 0; i < hl->buckets; i++) {
+        struct gol_hlnode *node = hl->table[i];
+        while (node != NULL) {
+            struct gol_hlnode *next = node->next;
+            size_t b = gol_hl_hash(node->nw, node->ne, node->sw, node->se) & (buckets - 1);
+            node->next = table[b];
+            table[b] = node;
+            node = next;
+        }
+    }
+    gol_dealloc(&hl->allocator, hl->table);
+    hl->table = table;
+    hl->buckets = buckets;
+}
+
+// PRIVATE
+// Provides the unique node made of the four children, creating it if it doesn't exist yet
+// Returns: The node, or NULL if out of memory
+static struct gol_hlnode *gol_hl_join(struct gol_hashlife *hl, struct gol_hlnode *nw, struct gol_hlnode *ne,
+                                      struct gol_hlnode *sw, struct gol_hlnode *se) {
+    if (nw == NULL || ne == NULL || sw == NULL || se == NULL) return NULL;
+
+    size_t b = gol_hl_hash(nw, ne, sw, se) & (hl->buckets - 1);
+    for (struct gol_hlnode *node = hl->table[b]; node != NULL; node = node->next) {
+        if (node->nw == nw && node->ne == ne && node->sw == sw && node->se == se) return node;
+    }
+
+    struct gol_hlnode *node = gol_hl_alloc(hl);
+    if (node == NULL) return NULL;
+    node->nw = nw;
+    node->ne = ne;
+    node->sw = sw;
+    node->se = se;
+    node->level = nw->level + 1;
+    node->population = nw->population + ne->population + sw->population + se->population;
+    node->next = hl->table[b];
+    hl->table[b] = node;
+
+    if (++hl->nodes > hl->buckets) gol_hl_grow(hl);
+    return node;
+}
+
+// PRIVATE
+// Provides the empty node of the provided level
+// Returns: The node, or NULL if out of memory
+static struct gol_hlnode *gol_hl_empty(struct gol_hashlife *hl, unsigned int level) {
+    if (hl->empty[level] == NULL) {
+        struct gol_hlnode *child = gol_hl_empty(hl, level - 1);
+        hl->empty[level] = gol_hl_join(hl, child, child, child, child);
+    }
+    return hl->empty[level];
+}
+
+// PRIVATE
+// The level-1 node at the center of a node
+static inline struct gol_hlnode *gol_hl_center(struct gol_hashlife *hl, const struct gol_hlnode *n) {
+    return gol_hl_join(hl, n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+}
+
+// PRIVATE
+// The node of the same level as w and e centered on the border between them
+static inline struct gol_hlnode *gol_hl_horizontal(struct gol_hashlife *hl, const struct gol_hlnode *w,
+                                                   const struct gol_hlnode *e) {
+    return gol_hl_join(hl, w->ne, e->nw, w->se, e->sw);
+}
+
+// PRIVATE
+// The node of the same level as n and s centered on the border between them
+static inline struct gol_hlnode *gol_hl_vertical(struct gol_hashlife *hl, const struct gol_hlnode *n,
+                                                 const struct gol_hlnode *s) {
+    return gol_hl_join(hl, n->sw, n->se, s->nw, s->ne);
+}
+
+// PRIVATE
+// Computes the center 2x2 cells of a 4x4 (level 2) node one generation later with the rule table
+static struct gol_hlnode *gol_hl_base(struct gol_hashlife *hl, const struct gol_hlnode *n) {
+    const struct gol_hlnode *quads[4] = {n->nw, n->ne, n->sw, n->se};
+    // gather the 16 cells, bit (y * 4 + x)
+    unsigned int bits = 0;
+    for (unsigned int y = 0; y < 4; y++) {
+        for (unsigned int x = 0; x < 4; x++) {
+            const struct gol_hlnode *q = quads[(y / 2) * 2 + x / 2];
+            const struct gol_hlnode *cells[4] = {q->nw, q->ne, q->sw, q->se};
+            if (cells[(y % 2) * 2 + x % 2]->population) bits |= 1u << (y * 4 + x);
+        }
+    }
+
+    struct gol_hlnode *next[4];
+    for (unsigned int i = 0; i < 4; i++) {
+        unsigned int cx = 1 + i % 2, cy = 1 + i / 2;
+        int live_neighbors = 0;
+        for (unsigned int y = cy - 1; y <= cy + 1; y++)
+            for (unsigned int x = cx - 1; x <= cx + 1; x++)
+                live_neighbors += (bits >> (y * 4 + x)) & 1;
+        bool is_alive = (bits >> (cy * 4 + cx)) & 1;
+        live_neighbors -= is_alive;
+        next[i] = hl->leaves[hl->rule[is_alive][live_neighbors]];
+    }
+    return gol_hl_join(hl, next[0], next[1], next[2], next[3]);
+}
+
+// PRIVATE
+// Provides the memoized result of a node: its center, 2^min(step_log, level - 2) generations later
+// Returns: The result, or NULL if out of memory
+static struct gol_hlnode *gol_hl_result(struct gol_hashlife *hl, struct gol_hlnode *n) {
+    if (n->result != NULL) return n->result;
+
+    struct gol_hlnode *r;
+    if (n->population == 0) {
+        r = gol_hl_empty(hl, n->level - 1);
+    } else if (n->level == 2) {
+        r = gol_hl_base(hl, n);
+    } else {
+        // the nine overlapping subnodes of the level below, in row-major order
+        struct gol_hlnode *sub[9] = {
+                n->nw, gol_hl_horizontal(hl, n->nw, n->ne), n->ne,
+                gol_hl_vertical(hl, n->nw, n->sw), gol_hl_center(hl, n), gol_hl_vertical(hl, n->ne, n->se),
+                n->sw, gol_hl_horizontal(hl, n->sw, n->se), n->se,
+        };
+        // at full speed both halves of the step advance the pattern, otherwise only the second one does
+        bool full = hl->step_log >= n->level - 2;
+        for (int i = 0; i < 9; i++) {
+            if (sub[i] == NULL) return NULL;
+            sub[i] = full ? gol_hl_result(hl, sub[i]) : gol_hl_center(hl, sub[i]);
+            if (sub[i] == NULL) return NULL;
+        }
+
+        struct gol_hlnode *nw = gol_hl_join(hl, sub[0], sub[1], sub[3], sub[4]);
+        struct gol_hlnode *ne = gol_hl_join(hl, sub[1], sub[2], sub[4], sub[5]);
+        struct gol_hlnode *sw = gol_hl_join(hl, sub[3], sub[4], sub[6], sub[7]);
+        struct gol_hlnode *se = gol_hl_join(hl, sub[4], sub[5], sub[7], sub[8]);
+        if (nw == NULL || ne == NULL || sw == NULL || se == NULL) return NULL;
+        r = gol_hl_join(hl, gol_hl_result(hl, nw), gol_hl_result(hl, ne), gol_hl_result(hl, sw),
+                        gol_hl_result(hl, se));
+    }
+
+    n->result = r;
+    return r;
+}
+
+// PRIVATE
+// Surrounds the root with empty space, doubling its size while keeping it centered on (0, 0)
+// Returns: The new root, or NULL if out of memory
+static struct gol_hlnode *gol_hl_expand(struct gol_hashlife *hl, struct gol_hlnode *root) {
+    struct gol_hlnode *e = gol_hl_empty(hl, root->level - 1);
+    return gol_hl_join(hl, gol_hl_join(hl, e, e, e, root->nw), gol_hl_join(hl, e, e, root->ne, e),
+                       gol_hl_join(hl, e, root->sw, e, e), gol_hl_join(hl, root->se, e, e, e));
+}
+
+// PRIVATE
+// Checks whether every live cell of the root is within its center quarter (the center of its center)
+static bool gol_hl_centered(const struct gol_hlnode *root) {
+    return root->nw->se->se->population + root->ne->sw->sw->population
+           + root->sw->ne->ne->population + root->se->nw->nw->population == root->population;
+}
+
+// what gol_hl_build builds nodes from: the board, the rectangle holding all of its live cells (see gol_bbox), and
+// the 16 level 1 nodes by their cells (bit 0 nw, 1 ne, 2 sw, 3 se)
+struct gol_hlsource {
+    const struct gameoflife *game;
+    gol_pos x, y, w, h;
+    struct gol_hlnode *quads[16];
+};
+
+// PRIVATE
+// Reads the 8 cells of row y from column x0 into the bits of a byte, bit i for column x0 + i, the cells off the board
+// dead. x0 is a multiple of 8 unless the whole universe is a single 8x8 node
+static unsigned int gol_hl_readbyte(const struct gameoflife *game, gol_pos x0, gol_pos y) {
+    gol_pos xa = x0 > 0 ? x0 : 0, xb = x0 + 8 < game->cols ? x0 + 8 : game->cols;
+    if (y < 0 || y >= game->rows || xa >= xb) return 0;
+    unsigned int bits = 0;
+    if (game->storage == GOL_STORAGE_PACKED) {
+        // padding bits past the last column are always dead, so only the words past the row's end are left out
+        const uint64_t *row = game->packed + (size_t)y * game->words;
+        size_t w = (size_t)xa / 64;
+        uint64_t word = row[w] >> (xa % 64);
+        if (xa % 64 > 56 && w + 1 < game->words) word |= row[w + 1] << (64 - xa % 64);
+        bits = (unsigned int) (word & ((1u << (xb - xa)) - 1));
+    } else {
+        const bool *row = game->board + (size_t)y * (size_t)game->cols;
+        for (gol_pos x = xa; x < xb; x++)
+            bits |= (unsigned int) row[x] << (x - xa);
+    }
+    return bits << (xa - x0);
+}
+
+// PRIVATE
+// Checks whether every cell of the board in the w x h rectangle from column x, row y (which must be on it) is dead,
+// reading whole words of packed rows and stopping at the first live cell
+static bool gol_hl_blank(const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w, gol_pos h) {
+    if (game->storage == GOL_STORAGE_BYTES) {
+        for (gol_pos row = y; row < y + h; row++) {
+            if (memchr(game->board + (size_t)row * (size_t)game->cols + x, true, (size_t)w) != NULL) return false;
+        }
+        return true;
+    }
+    const size_t first = (size_t)x / 64, last = (size_t)(x + w - 1) / 64;
+    const uint64_t first_mask = ~(uint64_t)0 << (x % 64);
+    const uint64_t last_mask = (x + w) % 64 ? ((uint64_t)1 << ((x + w) % 64)) - 1 : ~(uint64_t)0;
+    for (gol_pos row = y; row < y + h; row++) {
+        const uint64_t *words = game->packed + (size_t)row * game->words;
+        if (first == last) {
+            if (words[first] & first_mask & last_mask) return false;
+            continue;
+        }
+        if ((words[first] & first_mask) || (words[last] & last_mask)) return false;
+        for (size_t i = first + 1; i < last; i++) {
+            if (words[i]) return false;
+        }
+    }
+    return true;
+}
+
+// PRIVATE
+// Builds the node covering 2^level x 2^level cells from (x0, y0) out of the board's cells, level 3 at least
+// Space without live cells becomes the empty node of its level right away, the 8x8 nodes at the bottom are built from
+// a byte of each of their rows
+// Returns: The node, or NULL if out of memory
+static struct gol_hlnode *gol_hl_build(struct gol_hashlife *hl, const struct gol_hlsource *src, unsigned int level,
+                                       gol_pos x0, gol_pos y0) {
+    gol_pos size = (gol_pos)1 << level;
+    gol_pos xa = x0 > src->x ? x0 : src->x, xb = x0 + size < src->x + src->w ? x0 + size : src->x + src->w;
+    gol_pos ya = y0 > src->y ? y0 : src->y, yb = y0 + size < src->y + src->h ? y0 + size : src->y + src->h;
+    if (xa >= xb || ya >= yb) return gol_hl_empty(hl, level);
+
+    if (level == 3) {
+        unsigned int rows[8], any = 0;
+        for (int r = 0; r < 8; r++)
+            any |= rows[r] = gol_hl_readbyte(src->game, x0, y0 + r);
+        if (any == 0) return gol_hl_empty(hl, 3);
+        // the four 4x4 quadrants, each of four 2x2 nodes
+        struct gol_hlnode *quads[4];
+        for (int q = 0; q < 4; q++) {
+            struct gol_hlnode *sub[4];
+            for (int s = 0; s < 4; s++) {
+                unsigned int x = (unsigned int) (q % 2) * 4 + (unsigned int) (s % 2) * 2;
+                unsigned int y = (unsigned int) (q / 2) * 4 + (unsigned int) (s / 2) * 2;
+                unsigned int top = (rows[y] >> x) & 3, bottom = (rows[y + 1] >> x) & 3;
+                sub[s] = src->quads[top | bottom << 2];
+            }
+            quads[q] = gol_hl_join(hl, sub[0], sub[1], sub[2], sub[3]);
+        }
+        return gol_hl_join(hl, quads[0], quads[1], quads[2], quads[3]);
+    }
+    if (gol_hl_blank(src->game, xa, ya, xb - xa, yb - ya)) return gol_hl_empty(hl, level);
+
+    gol_pos half = size / 2;
+    return gol_hl_join(hl, gol_hl_build(hl, src, level - 1, x0, y0),
+                       gol_hl_build(hl, src, level - 1, x0 + half, y0),
+                       gol_hl_build(hl, src, level - 1, x0, y0 + half),
+                       gol_hl_build(hl, src, level - 1, x0 + half, y0 + half));
+}
+
+// PRIVATE
+// Provides the cells of row r of a node (of level 3 at most) as bits, bit x for column x
+static unsigned int gol_hl_rowbits(const struct gol_hlnode *node, unsigned int r) {
+    if (node->level == 0) return (unsigned int) node->population;
+    unsigned int half = 1u << (node->level - 1);
+    if (r < half) return gol_hl_rowbits(node->nw, r) | gol_hl_rowbits(node->ne, r) << half;
+    return gol_hl_rowbits(node->sw, r - half) | gol_hl_rowbits(node->se, r - half) << half;
+}
+
+// PRIVATE
+// Writes the live cells of the node covering 2^level x 2^level cells from (x0, y0) into the board, straight into its
+// buffer a row of a node of level 3 (or lower) at a time, the caller marks the board dirty
+static void gol_hl_write(const struct gol_hlnode *node, struct gameoflife *game, gol_pos x0, gol_pos y0) {
+    gol_pos size = (gol_pos)1 << node->level;
+    if (node->population == 0) return;
+    if (x0 >= game->cols || y0 >= game->rows || x0 + size <= 0 || y0 + size <= 0) return;
+
+    if (node->level <= 3) {
+        for (gol_pos r = 0; r < size; r++) {
+            gol_pos y = y0 + r;
+            unsigned int bits = gol_hl_rowbits(node, (unsigned int) r);
+            if (y < 0 || y >= game->rows || bits == 0) continue;
+            for (gol_pos c = 0; c < size; c++) {
+                gol_pos x = x0 + c;
+                if (!((bits >> c) & 1) || x < 0 || x >= game->cols) continue;
+                if (game->storage == GOL_STORAGE_PACKED)
+                    game->packed[(size_t)y * game->words + (size_t)x / 64] |= (uint64_t)1 << (x % 64);
+                else
+                    game->board[(size_t)y * (size_t)game->cols + x] = true;
+            }
+        }
+        return;
+    }
+    gol_pos half = size / 2;
+    gol_hl_write(node->nw, game, x0, y0);
+    gol_hl_write(node->ne, game, x0 + half, y0);
+    gol_hl_write(node->sw, game, x0, y0 + half);
+    gol_hl_write(node->se, game, x0 + half, y0 + half);
+}
+
+// PRIVATE
+// Marks a node and everything it is made of (and optionally its memoized results) as reachable
+// Returns: The number of nodes newly marked
+static size_t gol_hl_mark(struct gol_hlnode *node, bool results) {
+    if (node == NULL || node->marked || node->level == 0) return 0;
+    node->marked = true;
+
+    size_t marked = 1 + gol_hl_mark(node->nw, results) + gol_hl_mark(node->ne, results)
+                    + gol_hl_mark(node->sw, results) + gol_hl_mark(node->se, results);
+    if (results) marked += gol_hl_mark(node->result, results);
+    return marked;
+}
+
+// PRIVATE
+// Forgets every memoized result, they're only valid for the step size they were computed with
+static void gol_hl_clearresults(struct gol_hashlife *hl) {
+    for (size_t i = 0; i < hl->buckets; i++)
+        for (struct gol_hlnode *node = hl->table[i]; node != NULL; node = node->next)
+            node->result = NULL;
+}
+
+// Initializes an empty universe with a soft limit of max_nodes nodes (0 for the default), the nodes and the hash table
+// come from the allocator (NULL for the system heap)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE (an allocator function is missing), GOL_ERR_OK
+gol_err gol_hashlife_init(struct gol_hashlife *hl, size_t max_nodes, const struct gol_allocator *allocator) {
+    gol_err error;
+    memset(hl, 0, sizeof(struct gol_hashlife));
+    if ((error = gol_allocator_init(&hl->allocator, allocator)) != GOL_ERR_OK) return error;
+    hl->max_nodes = max_nodes ? max_nodes : GOL_HASHLIFE_DEFAULT_NODES;
+    memcpy(hl->rule, gol_conway.next, sizeof(hl->rule));
+
+    hl->buckets = 1024;
+    hl->table = (struct gol_hlnode **) gol_zalloc(&hl->allocator, hl->buckets, sizeof(struct gol_hlnode *));
+    if (hl->table == NULL) return GOL_ERR_NOMEM;
+
+    // the leaves aren't in the hash table, so they're never collected
+    for (int i = 0; i < 2; i++) {
+        hl->leaves[i] = gol_hl_alloc(hl);
+        if (hl->leaves[i] == NULL) {
+            gol_hashlife_free(hl);
+            return GOL_ERR_NOMEM;
+        }
+        hl->leaves[i]->population = (uint64_t)i;
+    }
+    hl->empty[0] = hl->leaves[0];
+
+    // start out with an empty 8x8 universe
+    hl->root = gol_hl_empty(hl, 3);
+    if (hl->root == NULL) {
+        gol_hashlife_free(hl);
+        return GOL_ERR_NOMEM;
+    }
+    return GOL_ERR_OK;
+}
+
+// Frees every node of the universe and resets the struct
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_hashlife_free(struct gol_hashlife *hl) {
+    struct gol_hlblock *block = hl->blocks;
+    while (block != NULL) {
+        struct gol_hlblock *next = block->next;
+        gol_dealloc(&hl->allocator, block);
+        block = next;
+    }
+    gol_dealloc(&hl->allocator, hl->table);
+    memset(hl, 0, sizeof(struct gol_hashlife));
+    return GOL_ERR_OK;
+}
+
+// Replaces the universe with the cells of the board, the board's rule is used for stepping from now on
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE (too large, or a B0 rule), GOL_ERR_IO,
+// GOL_ERR_OK
+gol_err gol_hashlife_load(struct gol_hashlife *hl, const struct gameoflife *game) {
+    gol_err error;
+    if (hl->table == NULL) return GOL_ERR_INIT;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    // the universe is infinite, so empty space has to stay empty
+    if (game->rule.birth & 1) return GOL_ERR_RANGE;
+    // the cells are read straight from host memory, so fetch them from a gpu first
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+
+    // the root is centered on (0, 0), so it has to reach the far side of the board on both axes
+    unsigned int level = 3;
+    while (((gol_pos)1 << (level - 1)) < game->rows || ((gol_pos)1 << (level - 1)) < game->cols) {
+        if (++level > GOL_HL_MAXLEVEL) return GOL_ERR_RANGE;
+    }
+    gol_pos half = (gol_pos)1 << (level - 1);
+
+    // only the rectangle holding the live cells is read at all
+    struct gol_hlsource src;
+    src.game = game;
+    if ((error = gol_bbox(game, &src.x, &src.y, &src.w, &src.h)) != GOL_ERR_OK) return error;
+    for (unsigned int i = 0; i < 16; i++) {
+        src.quads[i] = gol_hl_join(hl, hl->leaves[i & 1], hl->leaves[(i >> 1) & 1], hl->leaves[(i >> 2) & 1],
+                                   hl->leaves[(i >> 3) & 1]);
+        if (src.quads[i] == NULL) return GOL_ERR_NOMEM;
+    }
+    struct gol_hlnode *root = gol_hl_build(hl, &src, level, -half, -half);
+    if (root == NULL) return GOL_ERR_NOMEM;
+    hl->root = root;
+    hl->generation = 0;
+    // results memoized under another rule are of no use
+    memcpy(hl->rule, game->rule.next, sizeof(hl->rule));
+    gol_hl_clearresults(hl);
+    return GOL_ERR_OK;
+}
+
+// Clears the board and writes the live cells of the universe that are within its bounds into it
+// Only the nodes holding live cells on the board are visited, empty space is skipped whole
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_hashlife_export(const struct gol_hashlife *hl, struct gameoflife *game) {
+    gol_err error;
+    if (hl->root == NULL) return GOL_ERR_INIT;
+    if ((error = gol_clear(game)) != GOL_ERR_OK) return error;
+
+    gol_pos half = (gol_pos)1 << (hl->root->level - 1);
+    gol_hl_write(hl->root, game, -half, -half);
+    return gol_markdirty(game);
+}
+
+// Steps the universe forward 2^k generations
+// The root is grown until the pattern is far enough from its edges that nothing can escape during the step
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_hashlife_step(struct gol_hashlife *hl, unsigned int k) {
+    if (hl->root == NULL) return GOL_ERR_INIT;
+    if (k + 3 > GOL_HL_MAXLEVEL) return GOL_ERR_RANGE;
+
+    if (hl->nodes > hl->max_nodes) gol_hashlife_gc(hl);
+    // the memoized results are for a different step size
+    if (hl->step_log != k) {
+        gol_hl_clearresults(hl);
+        hl->step_log = k;
+    }
+
+    struct gol_hlnode *root = hl->root;
+    while (root->level < k + 3 || !gol_hl_centered(root)) {
+        if (root->level + 1 > GOL_HL_MAXLEVEL) return GOL_ERR_RANGE;
+        root = gol_hl_expand(hl, root);
+        if (root == NULL) return GOL_ERR_NOMEM;
+    }
+    // it's fine to keep the grown root if the step fails, it's the same pattern
+    hl->root = root;
+
+    struct gol_hlnode *next = gol_hl_result(hl, root);
+    if (next == NULL) return GOL_ERR_NOMEM;
+    hl->root = next;
+    hl->generation += (uint64_t)1 << k;
+
+    if (hl->nodes > hl->max_nodes) gol_hashlife_gc(hl);
+    return GOL_ERR_OK;
+}
+
+// Provides the bytes of memory held by the universe: its node blocks (used or not) and its hash table
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_hashlife_memory(const struct gol_hashlife *hl, size_t *bytes) {
+    size_t total = hl->buckets * sizeof(struct gol_hlnode *);
+    for (const struct gol_hlblock *block = hl->blocks; block != NULL; block = block->next)
+        total += sizeof(struct gol_hlblock);
+    *bytes = total;
+    return GOL_ERR_OK;
+}
+
+// Provides the number of live cells in the universe
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_hashlife_population(const struct gol_hashlife *hl, uint64_t *population) {
+    if (hl->root == NULL) return GOL_ERR_INIT;
+    *population = hl->root->population;
+    return GOL_ERR_OK;
+}
+
+// Frees every node that can't be reached from the root. Memoized results are kept alive as long as that leaves
+// the cache under half of its limit, otherwise all of them are dropped so the cache starts over from the universe alone
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_hashlife_gc(struct gol_hashlife *hl) {
+    if (hl->root == NULL) return GOL_ERR_INIT;
+
+    size_t marked = gol_hl_mark(hl->root, true);
+    for (unsigned int level = 1; level < 64; level++)
+        marked += gol_hl_mark(hl->empty[level], true);
+
+    if (marked > hl->max_nodes / 2) {
+        // too much to keep, start over with just the universe
+        for (size_t i = 0; i < hl->buckets; i++)
+            for (struct gol_hlnode *node = hl->table[i]; node != NULL; node = node->next)
+                node->marked = false;
+        gol_hl_clearresults(hl);
+        gol_hl_mark(hl->root, false);
+        for (unsigned int level = 1; level < 64; level++)
+            gol_hl_mark(hl->empty[level], false);
+    }
+
+    // sweep everything that wasn't marked into the freelist
+    for (size_t i = 0; i < hl->buckets; i++) {
+        struct gol_hlnode **link = &hl->table[i];
+        while (*link != NULL) {
+            struct gol_hlnode *node = *link;
+            if (node->marked) {
+                node->marked = false;
+                link = &node->next;
+            } else {
+                *link = node->next;
+                node->next = hl->freelist;
+                hl->freelist = node;
+                hl->nodes--;
+            }
+        }
+    }
+    return GOL_ERR_OK;
+}
@@ -0,0 +1,60 @@
+#ifndef C_PLAYGROUND_GOL_HASHLIFE_H
+#define C_PLAYGROUND_GOL_HASHLIFE_H
+
+#include "gol.h"
+
+// HashLife engine: the universe is a hash-consed quadtree, every node of which memoizes its own future,
+// so huge numbers of generations of sparse, structured patterns can be skipped at once.
+// Unlike gol_tick the universe has no edges, patterns loaded from a board are free to grow past its bounds.
+
+// default soft limit on the number of quadtree nodes (see gol_hashlife_init)
+#define GOL_HASHLIFE_DEFAULT_NODES ((size_t)1 << 22)
+
+struct gol_hlnode;
+struct gol_hlblock;
+
+struct gol_hashlife {
+    // the universe, centered on cell (0, 0)
+    struct gol_hlnode *root;
+    // generations stepped since the pattern was loaded
+    uint64_t generation;
+
+    // the next condition of a cell, copied from the board the pattern was loaded from
+    bool rule[2][9];
+    // log2 of the step size the memoized results were computed for
+    unsigned int step_log;
+
+    // hash table of every node, and the nodes to reuse after a garbage collection
+    struct gol_hlnode **table;
+    size_t buckets;
+    size_t nodes;
+    size_t max_nodes;
+    struct gol_hlnode *freelist;
+    struct gol_hlblock *blocks;
+    // the dead and alive leaves (single cells), and an empty node for every level
+    struct gol_hlnode *leaves[2];
+    struct gol_hlnode *empty[64];
+    // where the node blocks and the hash table come from
+    struct gol_allocator allocator;
+};
+
+// initializes an empty universe. max_nodes is a soft limit on the size of the memo cache, enforced by garbage
+// collection between steps (0 for GOL_HASHLIFE_DEFAULT_NODES). Its memory comes from the allocator, NULL for the system
+// heap, which is only ever called from the thread calling gol_hashlife_* functions
+gol_err gol_hashlife_init(struct gol_hashlife *hl, size_t max_nodes, const struct gol_allocator *allocator);
+// releases all nodes of the universe (except for the provided pointer itself)
+gol_err gol_hashlife_free(struct gol_hashlife *hl);
+// replaces the universe with the cells and the rule of the board, placing the board's cell (0, 0) at the universe's (0, 0)
+gol_err gol_hashlife_load(struct gol_hashlife *hl, const struct gameoflife *game);
+// writes the part of the universe covered by the board (from (0, 0) to (cols, rows)) into the board
+gol_err gol_hashlife_export(const struct gol_hashlife *hl, struct gameoflife *game);
+// steps the universe forward 2^k generations
+gol_err gol_hashlife_step(struct gol_hashlife *hl, unsigned int k);
+// provides the bytes of memory held by the universe and its memo cache
+gol_err gol_hashlife_memory(const struct gol_hashlife *hl, size_t *bytes);
+// provides the number of live cells in the universe
+gol_err gol_hashlife_population(const struct gol_hashlife *hl, uint64_t *population);
+// frees every node that isn't part of the current universe, keeping memoized results while they fit the limit
+gol_err gol_hashlife_gc(struct gol_hashlife *hl);
+
+#endif //C_PLAYGROUND_GOL_HASHLIFE_H
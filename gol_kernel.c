@@ -0,0 +1,908 @@
+#include "gol_kernel.h"
+
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GOL_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+#define GOL_KERNEL_NEON
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// A cell survives with 2 or 3 live neighbors and is reproduced with exactly 3, all other conditions mean it dies
+const struct gol_rule gol_conway = {
+        1u << 3, (1u << 2) | (1u << 3),
+        {
+                {false, false, false, true, false, false, false, false, false},
+                {false, false, true,  true, false, false, false, false, false},
+        },
+        true,
+};
+
+// PRIVATE
+// Calculates word w of a packed row, shifting in the bits of the neighboring words (or dead cells past the ends)
+static inline uint64_t gol_packedword(const uint64_t *up, const uint64_t *mid, const uint64_t *down,
+                                      size_t w, size_t words) {
+    uint64_t ul = w > 0 ? up[w - 1] : 0, ur = w + 1 < words ? up[w + 1] : 0;
+    uint64_t ml = w > 0 ? mid[w - 1] : 0, mr = w + 1 < words ? mid[w + 1] : 0;
+    uint64_t dl = w > 0 ? down[w - 1] : 0, dr = w + 1 < words ? down[w + 1] : 0;
+
+    return gol_wordnext((up[w] << 1) | (ul >> 63), up[w], (up[w] >> 1) | (ur << 63),
+                        (mid[w] << 1) | (ml >> 63), mid[w], (mid[w] >> 1) | (mr << 63),
+                        (down[w] << 1) | (dl >> 63), down[w], (down[w] >> 1) | (dr << 63));
+}
+
+// PRIVATE
+// Calculates word w of a packed row under any rule, like gol_packedword
+static inline uint64_t gol_packedwordrule(const struct gol_rule *rule, const uint64_t *up, const uint64_t *mid,
+                                          const uint64_t *down, size_t w, size_t words) {
+    uint64_t ul = w > 0 ? up[w - 1] : 0, ur = w + 1 < words ? up[w + 1] : 0;
+    uint64_t ml = w > 0 ? mid[w - 1] : 0, mr = w + 1 < words ? mid[w + 1] : 0;
+    uint64_t dl = w > 0 ? down[w - 1] : 0, dr = w + 1 < words ? down[w + 1] : 0;
+
+    return gol_wordrule(rule, (up[w] << 1) | (ul >> 63), up[w], (up[w] >> 1) | (ur << 63),
+                        (mid[w] << 1) | (ml >> 63), mid[w], (mid[w] >> 1) | (mr << 63),
+                        (down[w] << 1) | (dl >> 63), down[w], (down[w] >> 1) | (dr << 63));
+}
+
+// PRIVATE
+// Scalar byte row kernel for any rule, also used for the tail of every vectorized byte row kernel
+static void gol_bytesrule_scalar(const struct gol_rule *rule, const bool *up, const bool *mid, const bool *down,
+                                 bool *out, size_t count) {
+    for (size_t x = 0; x < count; x++) {
+        int live_neighbors = up[x - 1] + up[x] + up[x + 1]
+                             + mid[x - 1] + mid[x + 1]
+                             + down[x - 1] + down[x] + down[x + 1];
+        out[x] = rule->next[mid[x]][live_neighbors];
+    }
+}
+
+// PRIVATE
+// Scalar byte row kernel
+static void gol_bytesrow_scalar(const bool *up, const bool *mid, const bool *down, bool *out, size_t count) {
+    gol_bytesrule_scalar(&gol_conway, up, mid, down, out, count);
+}
+
+// PRIVATE
+// Scalar packed row kernel
+static void gol_packedrow_scalar(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                                 size_t w0, size_t w1, size_t words) {
+    for (size_t w = w0; w < w1; w++)
+        out[w] = gol_packedword(up, mid, down, w, words);
+}
+
+// PRIVATE
+// Scalar packed row kernel for any rule, also used by the vectorized kernels, which only specialize conway's rule
+static void gol_packedrule_scalar(const struct gol_rule *rule, const uint64_t *up, const uint64_t *mid,
+                                  const uint64_t *down, uint64_t *out, size_t w0, size_t w1, size_t words) {
+    for (size_t w = w0; w < w1; w++)
+        out[w] = gol_packedwordrule(rule, up, mid, down, w, words);
+}
+
+// PRIVATE
+// Scalar byte row count, also used for the tail of the vectorized ones
+static void gol_bytescount_scalar(const bool *before, const bool *after, size_t count, uint64_t counts[3]) {
+    for (size_t x = 0; x < count; x++) {
+        counts[0] += before[x];
+        counts[1] += after[x];
+        counts[2] += before[x] != after[x];
+    }
+}
+
+// PRIVATE
+// Scalar packed row count, also used for the tail of the vectorized one
+static void gol_packedcount_scalar(const uint64_t *before, const uint64_t *after, size_t count, uint64_t counts[3]) {
+    for (size_t w = 0; w < count; w++) {
+        counts[0] += gol_popcount64(before[w]);
+        counts[1] += gol_popcount64(after[w]);
+        counts[2] += gol_popcount64(before[w] ^ after[w]);
+    }
+}
+
+// PRIVATE
+// Scalar byte population count, also used for the tail of the vectorized ones
+static uint64_t gol_bytespopulation_scalar(const bool *cells, size_t count) {
+    uint64_t population = 0;
+    for (size_t x = 0; x < count; x++)
+        population += cells[x];
+    return population;
+}
+
+// PRIVATE
+// Scalar packed population count, also used for the tail of the vectorized ones
+static uint64_t gol_packedpopulation_scalar(const uint64_t *words, size_t count) {
+    uint64_t population = 0;
+    for (size_t w = 0; w < count; w++)
+        population += gol_popcount64(words[w]);
+    return population;
+}
+
+// PRIVATE
+// Scalar lanes row, also used for the tail of the vectorized ones
+static void gol_lanesrow_scalar(const struct gol_lanes *lanes, const uint64_t *up, const uint64_t *mid,
+                                const uint64_t *down, uint64_t *out, size_t count) {
+    const unsigned int shift = lanes->shift;
+    const uint64_t west = lanes->west, east = lanes->east;
+    for (size_t i = 0; i < count; i++) {
+        uint64_t u = up[i], m = mid[i], d = down[i];
+        out[i] = gol_wordnext((u << 1) | ((u >> shift) & west), u, (u >> 1) | ((u << shift) & east),
+                              (m << 1) | ((m >> shift) & west), m, (m >> 1) | ((m << shift) & east),
+                              (d << 1) | ((d >> shift) & west), d, (d >> 1) | ((d << shift) & east)) & lanes->mask;
+    }
+}
+
+// PRIVATE
+// Lists the keys (live_neighbors | is_alive << 4) of the conditions a rule makes a cell alive in
+// Returns: The number of keys written to 'keys', at most 18
+static unsigned int gol_rulekeys(const struct gol_rule *rule, uint8_t keys[18]) {
+    unsigned int count = 0;
+    for (unsigned int alive = 0; alive < 2; alive++) {
+        for (unsigned int n = 0; n <= 8; n++) {
+            if (rule->next[alive][n]) keys[count++] = (uint8_t) (n | alive << 4);
+        }
+    }
+    return count;
+}
+
+#ifdef GOL_KERNEL_X86
+// The byte kernels sum the eight neighbor bytes (each 0 or 1) lane by lane. For the conway rule a cell
+// is alive next generation exactly when (live_neighbors | is_alive) == 3, which is one compare per lane.
+
+__attribute__((target("sse2")))
+static void gol_bytesrow_sse2(const bool *up, const bool *mid, const bool *down, bool *out, size_t count) {
+    const __m128i three = _mm_set1_epi8(3), one = _mm_set1_epi8(1);
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        __m128i n = _mm_add_epi8(_mm_loadu_si128((const __m128i *) (up + x - 1)),
+                                 _mm_loadu_si128((const __m128i *) (up + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (up + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (mid + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (mid + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x + 1)));
+        __m128i alive = _mm_loadu_si128((const __m128i *) (mid + x));
+        __m128i next = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(n, alive), three), one);
+        _mm_storeu_si128((__m128i *) (out + x), next);
+    }
+    gol_bytesrow_scalar(up + x, mid + x, down + x, out + x, count - x);
+}
+
+// Other rules key every lane by its count and condition, and compare the keys against each condition the rule makes
+// a cell alive in. avx2 looks both halves of the rule up with a byte shuffle instead.
+
+__attribute__((target("sse2")))
+static void gol_bytesrule_sse2(const struct gol_rule *rule, const bool *up, const bool *mid, const bool *down,
+                               bool *out, size_t count) {
+    uint8_t keys[18];
+    const unsigned int key_count = gol_rulekeys(rule, keys);
+    const __m128i one = _mm_set1_epi8(1);
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        __m128i n = _mm_add_epi8(_mm_loadu_si128((const __m128i *) (up + x - 1)),
+                                 _mm_loadu_si128((const __m128i *) (up + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (up + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (mid + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (mid + x + 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x - 1)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x)));
+        n = _mm_add_epi8(n, _mm_loadu_si128((const __m128i *) (down + x + 1)));
+        // each byte of 'alive' is 0 or 1, so shifting the 16-bit lanes can't carry into the next byte
+        __m128i key = _mm_or_si128(n, _mm_slli_epi16(_mm_loadu_si128((const __m128i *) (mid + x)), 4));
+        __m128i next = _mm_setzero_si128();
+        for (unsigned int i = 0; i < key_count; i++)
+            next = _mm_or_si128(next, _mm_cmpeq_epi8(key, _mm_set1_epi8((char) keys[i])));
+        _mm_storeu_si128((__m128i *) (out + x), _mm_and_si128(next, one));
+    }
+    gol_bytesrule_scalar(rule, up + x, mid + x, down + x, out + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static void gol_bytesrow_avx2(const bool *up, const bool *mid, const bool *down, bool *out, size_t count) {
+    const __m256i three = _mm256_set1_epi8(3), one = _mm256_set1_epi8(1);
+    size_t x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i n = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *) (up + x - 1)),
+                                    _mm256_loadu_si256((const __m256i *) (up + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (up + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (mid + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (mid + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x + 1)));
+        __m256i alive = _mm256_loadu_si256((const __m256i *) (mid + x));
+        __m256i next = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_or_si256(n, alive), three), one);
+        _mm256_storeu_si256((__m256i *) (out + x), next);
+    }
+    // the tail runs sse2 code, which stalls on the upper halves of the ymm registers unless they are cleared
+    _mm256_zeroupper();
+    gol_bytesrow_sse2(up + x, mid + x, down + x, out + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static void gol_bytesrule_avx2(const struct gol_rule *rule, const bool *up, const bool *mid, const bool *down,
+                               bool *out, size_t count) {
+    // the next condition of dead and live cells by neighbor count, once for each 128-bit lane of the shuffle
+    uint8_t tables[2][32] = {{0}};
+    for (unsigned int n = 0; n <= 8; n++) {
+        tables[0][n] = tables[0][n + 16] = rule->next[0][n];
+        tables[1][n] = tables[1][n + 16] = rule->next[1][n];
+    }
+    const __m256i born = _mm256_loadu_si256((const __m256i *) tables[0]);
+    const __m256i survive = _mm256_loadu_si256((const __m256i *) tables[1]);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i n = _mm256_add_epi8(_mm256_loadu_si256((const __m256i *) (up + x - 1)),
+                                    _mm256_loadu_si256((const __m256i *) (up + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (up + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (mid + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (mid + x + 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x - 1)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x)));
+        n = _mm256_add_epi8(n, _mm256_loadu_si256((const __m256i *) (down + x + 1)));
+        __m256i dead = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (mid + x)), zero);
+        __m256i next = _mm256_blendv_epi8(_mm256_shuffle_epi8(survive, n), _mm256_shuffle_epi8(born, n), dead);
+        _mm256_storeu_si256((__m256i *) (out + x), next);
+    }
+    _mm256_zeroupper();
+    gol_bytesrule_sse2(rule, up + x, mid + x, down + x, out + x, count - x);
+}
+
+// The packed kernels run the same adder network as gol_wordnext over 2 or 4 words at a time. The
+// west/east neighbors of a vector of words come from unaligned loads one word before and after it.
+
+__attribute__((target("sse2")))
+static void gol_packedrow_sse2(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                               size_t w0, size_t w1, size_t words) {
+#define GOL_SSE2_LOAD(p) _mm_loadu_si128((const __m128i *) (p))
+#define GOL_SSE2_WEST(p) _mm_or_si128(_mm_slli_epi64(GOL_SSE2_LOAD(p), 1), _mm_srli_epi64(GOL_SSE2_LOAD((p) - 1), 63))
+#define GOL_SSE2_EAST(p) _mm_or_si128(_mm_srli_epi64(GOL_SSE2_LOAD(p), 1), _mm_slli_epi64(GOL_SSE2_LOAD((p) + 1), 63))
+    // the first and last words of the row have a neighbor word missing, so are done by gol_packedword
+    size_t w = w0;
+    if (w == 0 && w < w1) {
+        out[0] = gol_packedword(up, mid, down, 0, words);
+        w++;
+    }
+    for (; w + 2 <= w1 && w + 2 < words; w += 2) {
+        __m128i uw = GOL_SSE2_WEST(up + w), uc = GOL_SSE2_LOAD(up + w), ue = GOL_SSE2_EAST(up + w);
+        __m128i mw = GOL_SSE2_WEST(mid + w), mc = GOL_SSE2_LOAD(mid + w), me = GOL_SSE2_EAST(mid + w);
+        __m128i dw = GOL_SSE2_WEST(down + w), dc = GOL_SSE2_LOAD(down + w), de = GOL_SSE2_EAST(down + w);
+
+        __m128i ux = _mm_xor_si128(uw, uc), us = _mm_xor_si128(ux, ue);
+        __m128i uk = _mm_or_si128(_mm_and_si128(uw, uc), _mm_and_si128(ue, ux));
+        __m128i dx = _mm_xor_si128(dw, dc), ds = _mm_xor_si128(dx, de);
+        __m128i dk = _mm_or_si128(_mm_and_si128(dw, dc), _mm_and_si128(de, dx));
+        __m128i ms = _mm_xor_si128(mw, me), mk = _mm_and_si128(mw, me);
+
+        __m128i sx = _mm_xor_si128(us, ms), ones = _mm_xor_si128(sx, ds);
+        __m128i k = _mm_or_si128(_mm_and_si128(us, ms), _mm_and_si128(ds, sx));
+        __m128i tx = _mm_xor_si128(uk, mk), t = _mm_xor_si128(tx, dk);
+        __m128i tk = _mm_or_si128(_mm_and_si128(uk, mk), _mm_and_si128(dk, tx));
+        __m128i twos = _mm_xor_si128(t, k);
+        __m128i tkk = _mm_and_si128(t, k);
+        // fours and eights are both excluded, and (tk ^ tkk) | (tk & tkk) == tk | tkk
+        __m128i high = _mm_or_si128(tk, tkk);
+
+        __m128i next = _mm_andnot_si128(high, _mm_and_si128(twos, _mm_or_si128(ones, mc)));
+        _mm_storeu_si128((__m128i *) (out + w), next);
+    }
+    for (; w < w1; w++)
+        out[w] = gol_packedword(up, mid, down, w, words);
+#undef GOL_SSE2_LOAD
+#undef GOL_SSE2_WEST
+#undef GOL_SSE2_EAST
+}
+
+__attribute__((target("avx2")))
+static void gol_packedrow_avx2(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                               size_t w0, size_t w1, size_t words) {
+#define GOL_AVX2_LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#define GOL_AVX2_WEST(p) _mm256_or_si256(_mm256_slli_epi64(GOL_AVX2_LOAD(p), 1), \
+                                         _mm256_srli_epi64(GOL_AVX2_LOAD((p) - 1), 63))
+#define GOL_AVX2_EAST(p) _mm256_or_si256(_mm256_srli_epi64(GOL_AVX2_LOAD(p), 1), \
+                                         _mm256_slli_epi64(GOL_AVX2_LOAD((p) + 1), 63))
+    // the first and last words of the row have a neighbor word missing, so are done by gol_packedword
+    size_t w = w0;
+    if (w == 0 && w < w1) {
+        out[0] = gol_packedword(up, mid, down, 0, words);
+        w++;
+    }
+    for (; w + 4 <= w1 && w + 4 < words; w += 4) {
+        __m256i uw = GOL_AVX2_WEST(up + w), uc = GOL_AVX2_LOAD(up + w), ue = GOL_AVX2_EAST(up + w);
+        __m256i mw = GOL_AVX2_WEST(mid + w), mc = GOL_AVX2_LOAD(mid + w), me = GOL_AVX2_EAST(mid + w);
+        __m256i dw = GOL_AVX2_WEST(down + w), dc = GOL_AVX2_LOAD(down + w), de = GOL_AVX2_EAST(down + w);
+
+        __m256i ux = _mm256_xor_si256(uw, uc), us = _mm256_xor_si256(ux, ue);
+        __m256i uk = _mm256_or_si256(_mm256_and_si256(uw, uc), _mm256_and_si256(ue, ux));
+        __m256i dx = _mm256_xor_si256(dw, dc), ds = _mm256_xor_si256(dx, de);
+        __m256i dk = _mm256_or_si256(_mm256_and_si256(dw, dc), _mm256_and_si256(de, dx));
+        __m256i ms = _mm256_xor_si256(mw, me), mk = _mm256_and_si256(mw, me);
+
+        __m256i sx = _mm256_xor_si256(us, ms), ones = _mm256_xor_si256(sx, ds);
+        __m256i k = _mm256_or_si256(_mm256_and_si256(us, ms), _mm256_and_si256(ds, sx));
+        __m256i tx = _mm256_xor_si256(uk, mk), t = _mm256_xor_si256(tx, dk);
+        __m256i tk = _mm256_or_si256(_mm256_and_si256(uk, mk), _mm256_and_si256(dk, tx));
+        __m256i twos = _mm256_xor_si256(t, k);
+        __m256i high = _mm256_or_si256(tk, _mm256_and_si256(t, k));
+
+        __m256i next = _mm256_andnot_si256(high, _mm256_and_si256(twos, _mm256_or_si256(ones, mc)));
+        _mm256_storeu_si256((__m256i *) (out + w), next);
+    }
+    _mm256_zeroupper();
+    for (; w < w1; w++)
+        out[w] = gol_packedword(up, mid, down, w, words);
+#undef GOL_AVX2_LOAD
+#undef GOL_AVX2_WEST
+#undef GOL_AVX2_EAST
+}
+
+// PRIVATE
+// Selects the cells of 4 words whose neighbor count has its bit set in 'counts', like gol_wordcounts
+__attribute__((target("avx2")))
+static inline __m256i gol_countsavx2(uint16_t counts, __m256i ones, __m256i twos, __m256i fours, __m256i eights) {
+    const __m256i all = _mm256_set1_epi64x(-1);
+    __m256i cells = _mm256_setzero_si256();
+    for (unsigned int n = 0; n <= 8; n++) {
+        if (!((counts >> n) & 1)) continue;
+        __m256i match = _mm256_xor_si256(ones, n & 1 ? _mm256_setzero_si256() : all);
+        match = _mm256_and_si256(match, _mm256_xor_si256(twos, n & 2 ? _mm256_setzero_si256() : all));
+        match = _mm256_and_si256(match, _mm256_xor_si256(fours, n & 4 ? _mm256_setzero_si256() : all));
+        match = _mm256_and_si256(match, _mm256_xor_si256(eights, n & 8 ? _mm256_setzero_si256() : all));
+        cells = _mm256_or_si256(cells, match);
+    }
+    return cells;
+}
+
+__attribute__((target("avx2")))
+static void gol_packedrule_avx2(const struct gol_rule *rule, const uint64_t *up, const uint64_t *mid,
+                                const uint64_t *down, uint64_t *out, size_t w0, size_t w1, size_t words) {
+#define GOL_AVX2_LOAD(p) _mm256_loadu_si256((const __m256i *) (p))
+#define GOL_AVX2_WEST(p) _mm256_or_si256(_mm256_slli_epi64(GOL_AVX2_LOAD(p), 1), \
+                                         _mm256_srli_epi64(GOL_AVX2_LOAD((p) - 1), 63))
+#define GOL_AVX2_EAST(p) _mm256_or_si256(_mm256_srli_epi64(GOL_AVX2_LOAD(p), 1), \
+                                         _mm256_slli_epi64(GOL_AVX2_LOAD((p) + 1), 63))
+    size_t w = w0;
+    if (w == 0 && w < w1) {
+        out[0] = gol_packedwordrule(rule, up, mid, down, 0, words);
+        w++;
+    }
+    for (; w + 4 <= w1 && w + 4 < words; w += 4) {
+        __m256i uw = GOL_AVX2_WEST(up + w), uc = GOL_AVX2_LOAD(up + w), ue = GOL_AVX2_EAST(up + w);
+        __m256i mw = GOL_AVX2_WEST(mid + w), mc = GOL_AVX2_LOAD(mid + w), me = GOL_AVX2_EAST(mid + w);
+        __m256i dw = GOL_AVX2_WEST(down + w), dc = GOL_AVX2_LOAD(down + w), de = GOL_AVX2_EAST(down + w);
+
+        __m256i ux = _mm256_xor_si256(uw, uc), us = _mm256_xor_si256(ux, ue);
+        __m256i uk = _mm256_or_si256(_mm256_and_si256(uw, uc), _mm256_and_si256(ue, ux));
+        __m256i dx = _mm256_xor_si256(dw, dc), ds = _mm256_xor_si256(dx, de);
+        __m256i dk = _mm256_or_si256(_mm256_and_si256(dw, dc), _mm256_and_si256(de, dx));
+        __m256i ms = _mm256_xor_si256(mw, me), mk = _mm256_and_si256(mw, me);
+
+        __m256i sx = _mm256_xor_si256(us, ms), ones = _mm256_xor_si256(sx, ds);
+        __m256i k = _mm256_or_si256(_mm256_and_si256(us, ms), _mm256_and_si256(ds, sx));
+        __m256i tx = _mm256_xor_si256(uk, mk), t = _mm256_xor_si256(tx, dk);
+        __m256i tk = _mm256_or_si256(_mm256_and_si256(uk, mk), _mm256_and_si256(dk, tx));
+        __m256i tkk = _mm256_and_si256(t, k);
+        __m256i twos = _mm256_xor_si256(t, k), fours = _mm256_xor_si256(tk, tkk), eights = _mm256_and_si256(tk, tkk);
+
+        __m256i survive = gol_countsavx2(rule->survive, ones, twos, fours, eights);
+        __m256i born = gol_countsavx2(rule->birth, ones, twos, fours, eights);
+        __m256i next = _mm256_or_si256(_mm256_and_si256(mc, survive), _mm256_andnot_si256(mc, born));
+        _mm256_storeu_si256((__m256i *) (out + w), next);
+    }
+    _mm256_zeroupper();
+    for (; w < w1; w++)
+        out[w] = gol_packedwordrule(rule, up, mid, down, w, words);
+#undef GOL_AVX2_LOAD
+#undef GOL_AVX2_WEST
+#undef GOL_AVX2_EAST
+}
+
+// The counts sum bytes (each 0 or 1) with psadbw, which adds up every 8 bytes into a 64-bit lane. The bits of packed
+// words are counted per byte first, with shifts and masks (sse2) or by looking up every nibble with a byte shuffle (avx2).
+
+__attribute__((target("sse2")))
+static void gol_bytescount_sse2(const bool *before, const bool *after, size_t count, uint64_t counts[3]) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums[3] = {zero, zero, zero};
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *) (before + x)), a = _mm_loadu_si128((const __m128i *) (after + x));
+        sums[0] = _mm_add_epi64(sums[0], _mm_sad_epu8(b, zero));
+        sums[1] = _mm_add_epi64(sums[1], _mm_sad_epu8(a, zero));
+        sums[2] = _mm_add_epi64(sums[2], _mm_sad_epu8(_mm_xor_si128(b, a), zero));
+    }
+    for (int i = 0; i < 3; i++) {
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i *) lanes, sums[i]);
+        counts[i] += lanes[0] + lanes[1];
+    }
+    gol_bytescount_scalar(before + x, after + x, count - x, counts);
+}
+
+__attribute__((target("avx2")))
+static void gol_bytescount_avx2(const bool *before, const bool *after, size_t count, uint64_t counts[3]) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums[3] = {zero, zero, zero};
+    size_t x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i b = _mm256_loadu_si256((const __m256i *) (before + x));
+        __m256i a = _mm256_loadu_si256((const __m256i *) (after + x));
+        sums[0] = _mm256_add_epi64(sums[0], _mm256_sad_epu8(b, zero));
+        sums[1] = _mm256_add_epi64(sums[1], _mm256_sad_epu8(a, zero));
+        sums[2] = _mm256_add_epi64(sums[2], _mm256_sad_epu8(_mm256_xor_si256(b, a), zero));
+    }
+    for (int i = 0; i < 3; i++) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i *) lanes, sums[i]);
+        counts[i] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    _mm256_zeroupper();
+    gol_bytescount_sse2(before + x, after + x, count - x, counts);
+}
+
+// PRIVATE
+// Counts the set bits of 2 words into their 64-bit lanes, by adding up neighboring bits, pairs and nibbles in place
+__attribute__((target("sse2")))
+static inline __m128i gol_popcountsse2(__m128i words) {
+    __m128i bits = _mm_sub_epi8(words, _mm_and_si128(_mm_srli_epi16(words, 1), _mm_set1_epi8(0x55)));
+    bits = _mm_add_epi8(_mm_and_si128(bits, _mm_set1_epi8(0x33)),
+                        _mm_and_si128(_mm_srli_epi16(bits, 2), _mm_set1_epi8(0x33)));
+    bits = _mm_and_si128(_mm_add_epi8(bits, _mm_srli_epi16(bits, 4)), _mm_set1_epi8(0x0f));
+    return _mm_sad_epu8(bits, _mm_setzero_si128());
+}
+
+__attribute__((target("sse2")))
+static void gol_packedcount_sse2(const uint64_t *before, const uint64_t *after, size_t count, uint64_t counts[3]) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums[3] = {zero, zero, zero};
+    size_t w = 0;
+    for (; w + 2 <= count; w += 2) {
+        __m128i b = _mm_loadu_si128((const __m128i *) (before + w)), a = _mm_loadu_si128((const __m128i *) (after + w));
+        sums[0] = _mm_add_epi64(sums[0], gol_popcountsse2(b));
+        sums[1] = _mm_add_epi64(sums[1], gol_popcountsse2(a));
+        sums[2] = _mm_add_epi64(sums[2], gol_popcountsse2(_mm_xor_si128(b, a)));
+    }
+    for (int i = 0; i < 3; i++) {
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i *) lanes, sums[i]);
+        counts[i] += lanes[0] + lanes[1];
+    }
+    gol_packedcount_scalar(before + w, after + w, count - w, counts);
+}
+
+__attribute__((target("sse2")))
+static uint64_t gol_bytespopulation_sse2(const bool *cells, size_t count) {
+    __m128i sum = _mm_setzero_si128();
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16)
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_loadu_si128((const __m128i *) (cells + x)), _mm_setzero_si128()));
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, sum);
+    return lanes[0] + lanes[1] + gol_bytespopulation_scalar(cells + x, count - x);
+}
+
+__attribute__((target("sse2")))
+static uint64_t gol_packedpopulation_sse2(const uint64_t *words, size_t count) {
+    __m128i sum = _mm_setzero_si128();
+    size_t w = 0;
+    for (; w + 2 <= count; w += 2)
+        sum = _mm_add_epi64(sum, gol_popcountsse2(_mm_loadu_si128((const __m128i *) (words + w))));
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, sum);
+    return lanes[0] + lanes[1] + gol_packedpopulation_scalar(words + w, count - w);
+}
+
+// PRIVATE
+// Counts the set bits of every byte of 4 words, summed into each word's 64-bit lane
+__attribute__((target("avx2")))
+static inline __m256i gol_popcountavx2(__m256i words) {
+    const __m256i nibbles = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i bits = _mm256_add_epi8(_mm256_shuffle_epi8(nibbles, _mm256_and_si256(words, low)),
+                                   _mm256_shuffle_epi8(nibbles, _mm256_and_si256(_mm256_srli_epi16(words, 4), low)));
+    return _mm256_sad_epu8(bits, _mm256_setzero_si256());
+}
+
+__attribute__((target("avx2")))
+static void gol_packedcount_avx2(const uint64_t *before, const uint64_t *after, size_t count, uint64_t counts[3]) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i sums[3] = {zero, zero, zero};
+    size_t w = 0;
+    for (; w + 4 <= count; w += 4) {
+        __m256i b = _mm256_loadu_si256((const __m256i *) (before + w));
+        __m256i a = _mm256_loadu_si256((const __m256i *) (after + w));
+        sums[0] = _mm256_add_epi64(sums[0], gol_popcountavx2(b));
+        sums[1] = _mm256_add_epi64(sums[1], gol_popcountavx2(a));
+        sums[2] = _mm256_add_epi64(sums[2], gol_popcountavx2(_mm256_xor_si256(b, a)));
+    }
+    for (int i = 0; i < 3; i++) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i *) lanes, sums[i]);
+        counts[i] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    _mm256_zeroupper();
+    gol_packedcount_scalar(before + w, after + w, count - w, counts);
+}
+
+__attribute__((target("avx2")))
+static uint64_t gol_bytespopulation_avx2(const bool *cells, size_t count) {
+    __m256i sum = _mm256_setzero_si256();
+    size_t x = 0;
+    for (; x + 32 <= count; x += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *) (cells + x));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, sum);
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + gol_bytespopulation_sse2(cells + x, count - x);
+}
+
+__attribute__((target("avx2")))
+static uint64_t gol_packedpopulation_avx2(const uint64_t *words, size_t count) {
+    __m256i sum = _mm256_setzero_si256();
+    size_t w = 0;
+    for (; w + 4 <= count; w += 4)
+        sum = _mm256_add_epi64(sum, gol_popcountavx2(_mm256_loadu_si256((const __m256i *) (words + w))));
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, sum);
+    _mm256_zeroupper();
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + gol_packedpopulation_scalar(words + w, count - w);
+}
+
+__attribute__((target("sse2")))
+static void gol_lanesrow_sse2(const struct gol_lanes *lanes, const uint64_t *up, const uint64_t *mid,
+                              const uint64_t *down, uint64_t *out, size_t count) {
+    const __m128i shift = _mm_cvtsi32_si128((int)lanes->shift);
+    const __m128i west = _mm_set1_epi64x((long long)lanes->west), east = _mm_set1_epi64x((long long)lanes->east);
+    const __m128i mask = _mm_set1_epi64x((long long)lanes->mask);
+#define GOL_SSE2_WEST(v) _mm_or_si128(_mm_slli_epi64(v, 1), _mm_and_si128(_mm_srl_epi64(v, shift), west))
+#define GOL_SSE2_EAST(v) _mm_or_si128(_mm_srli_epi64(v, 1), _mm_and_si128(_mm_sll_epi64(v, shift), east))
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i uc = _mm_loadu_si128((const __m128i *) (up + i)), uw = GOL_SSE2_WEST(uc), ue = GOL_SSE2_EAST(uc);
+        __m128i mc = _mm_loadu_si128((const __m128i *) (mid + i)), mw = GOL_SSE2_WEST(mc), me = GOL_SSE2_EAST(mc);
+        __m128i dc = _mm_loadu_si128((const __m128i *) (down + i)), dw = GOL_SSE2_WEST(dc), de = GOL_SSE2_EAST(dc);
+
+        __m128i ux = _mm_xor_si128(uw, uc), us = _mm_xor_si128(ux, ue);
+        __m128i uk = _mm_or_si128(_mm_and_si128(uw, uc), _mm_and_si128(ue, ux));
+        __m128i dx = _mm_xor_si128(dw, dc), ds = _mm_xor_si128(dx, de);
+        __m128i dk = _mm_or_si128(_mm_and_si128(dw, dc), _mm_and_si128(de, dx));
+        __m128i ms = _mm_xor_si128(mw, me), mk = _mm_and_si128(mw, me);
+
+        __m128i sx = _mm_xor_si128(us, ms), ones = _mm_xor_si128(sx, ds);
+        __m128i k = _mm_or_si128(_mm_and_si128(us, ms), _mm_and_si128(ds, sx));
+        __m128i tx = _mm_xor_si128(uk, mk), t = _mm_xor_si128(tx, dk);
+        __m128i tk = _mm_or_si128(_mm_and_si128(uk, mk), _mm_and_si128(dk, tx));
+        __m128i twos = _mm_xor_si128(t, k);
+        __m128i high = _mm_or_si128(tk, _mm_and_si128(t, k));
+
+        __m128i next = _mm_andnot_si128(high, _mm_and_si128(twos, _mm_or_si128(ones, mc)));
+        _mm_storeu_si128((__m128i *) (out + i), _mm_and_si128(next, mask));
+    }
+    gol_lanesrow_scalar(lanes, up + i, mid + i, down + i, out + i, count - i);
+#undef GOL_SSE2_WEST
+#undef GOL_SSE2_EAST
+}
+
+__attribute__((target("avx2")))
+static void gol_lanesrow_avx2(const struct gol_lanes *lanes, const uint64_t *up, const uint64_t *mid,
+                              const uint64_t *down, uint64_t *out, size_t count) {
+    const __m128i shift = _mm_cvtsi32_si128((int)lanes->shift);
+    const __m256i west = _mm256_set1_epi64x((long long)lanes->west);
+    const __m256i east = _mm256_set1_epi64x((long long)lanes->east);
+    const __m256i mask = _mm256_set1_epi64x((long long)lanes->mask);
+#define GOL_AVX2_WEST(v) _mm256_or_si256(_mm256_slli_epi64(v, 1), _mm256_and_si256(_mm256_srl_epi64(v, shift), west))
+#define GOL_AVX2_EAST(v) _mm256_or_si256(_mm256_srli_epi64(v, 1), _mm256_and_si256(_mm256_sll_epi64(v, shift), east))
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i uc = _mm256_loadu_si256((const __m256i *) (up + i)), uw = GOL_AVX2_WEST(uc), ue = GOL_AVX2_EAST(uc);
+        __m256i mc = _mm256_loadu_si256((const __m256i *) (mid + i)), mw = GOL_AVX2_WEST(mc), me = GOL_AVX2_EAST(mc);
+        __m256i dc = _mm256_loadu_si256((const __m256i *) (down + i)), dw = GOL_AVX2_WEST(dc), de = GOL_AVX2_EAST(dc);
+
+        __m256i ux = _mm256_xor_si256(uw, uc), us = _mm256_xor_si256(ux, ue);
+        __m256i uk = _mm256_or_si256(_mm256_and_si256(uw, uc), _mm256_and_si256(ue, ux));
+        __m256i dx = _mm256_xor_si256(dw, dc), ds = _mm256_xor_si256(dx, de);
+        __m256i dk = _mm256_or_si256(_mm256_and_si256(dw, dc), _mm256_and_si256(de, dx));
+        __m256i ms = _mm256_xor_si256(mw, me), mk = _mm256_and_si256(mw, me);
+
+        __m256i sx = _mm256_xor_si256(us, ms), ones = _mm256_xor_si256(sx, ds);
+        __m256i k = _mm256_or_si256(_mm256_and_si256(us, ms), _mm256_and_si256(ds, sx));
+        __m256i tx = _mm256_xor_si256(uk, mk), t = _mm256_xor_si256(tx, dk);
+        __m256i tk = _mm256_or_si256(_mm256_and_si256(uk, mk), _mm256_and_si256(dk, tx));
+        __m256i twos = _mm256_xor_si256(t, k);
+        __m256i high = _mm256_or_si256(tk, _mm256_and_si256(t, k));
+
+        __m256i next = _mm256_andnot_si256(high, _mm256_and_si256(twos, _mm256_or_si256(ones, mc)));
+        _mm256_storeu_si256((__m256i *) (out + i), _mm256_and_si256(next, mask));
+    }
+    _mm256_zeroupper();
+    gol_lanesrow_scalar(lanes, up + i, mid + i, down + i, out + i, count - i);
+#undef GOL_AVX2_WEST
+#undef GOL_AVX2_EAST
+}
+#endif //GOL_KERNEL_X86
+
+#ifdef GOL_KERNEL_NEON
+static void gol_bytesrow_neon(const bool *up, const bool *mid, const bool *down, bool *out, size_t count) {
+    const uint8x16_t three = vdupq_n_u8(3), one = vdupq_n_u8(1);
+    const uint8_t *u = (const uint8_t *) up, *m = (const uint8_t *) mid, *d = (const uint8_t *) down;
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16_t n = vaddq_u8(vld1q_u8(u + x - 1), vld1q_u8(u + x));
+        n = vaddq_u8(n, vld1q_u8(u + x + 1));
+        n = vaddq_u8(n, vld1q_u8(m + x - 1));
+        n = vaddq_u8(n, vld1q_u8(m + x + 1));
+        n = vaddq_u8(n, vld1q_u8(d + x - 1));
+        n = vaddq_u8(n, vld1q_u8(d + x));
+        n = vaddq_u8(n, vld1q_u8(d + x + 1));
+        uint8x16_t next = vandq_u8(vceqq_u8(vorrq_u8(n, vld1q_u8(m + x)), three), one);
+        vst1q_u8((uint8_t *) (out + x), next);
+    }
+    gol_bytesrow_scalar(up + x, mid + x, down + x, out + x, count - x);
+}
+
+// Other rules key every lane by its count and condition, and compare the keys against each condition the rule makes
+// a cell alive in
+static void gol_bytesrule_neon(const struct gol_rule *rule, const bool *up, const bool *mid, const bool *down,
+                               bool *out, size_t count) {
+    uint8_t keys[18];
+    const unsigned int key_count = gol_rulekeys(rule, keys);
+    const uint8x16_t one = vdupq_n_u8(1);
+    const uint8_t *u = (const uint8_t *) up, *m = (const uint8_t *) mid, *d = (const uint8_t *) down;
+    size_t x = 0;
+    for (; x + 16 <= count; x += 16) {
+        uint8x16_t n = vaddq_u8(vld1q_u8(u + x - 1), vld1q_u8(u + x));
+        n = vaddq_u8(n, vld1q_u8(u + x + 1));
+        n = vaddq_u8(n, vld1q_u8(m + x - 1));
+        n = vaddq_u8(n, vld1q_u8(m + x + 1));
+        n = vaddq_u8(n, vld1q_u8(d + x - 1));
+        n = vaddq_u8(n, vld1q_u8(d + x));
+        n = vaddq_u8(n, vld1q_u8(d + x + 1));
+        uint8x16_t key = vorrq_u8(n, vshlq_n_u8(vld1q_u8(m + x), 4));
+        uint8x16_t next = vdupq_n_u8(0);
+        for (unsigned int i = 0; i < key_count; i++)
+            next = vorrq_u8(next, vceqq_u8(key, vdupq_n_u8(keys[i])));
+        vst1q_u8((uint8_t *) (out + x), vandq_u8(next, one));
+    }
+    gol_bytesrule_scalar(rule, up + x, mid + x, down + x, out + x, count - x);
+}
+
+static void gol_packedrow_neon(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                               size_t w0, size_t w1, size_t words) {
+#define GOL_NEON_WEST(p) vorrq_u64(vshlq_n_u64(vld1q_u64(p), 1), vshrq_n_u64(vld1q_u64((p) - 1), 63))
+#define GOL_NEON_EAST(p) vorrq_u64(vshrq_n_u64(vld1q_u64(p), 1), vshlq_n_u64(vld1q_u64((p) + 1), 63))
+    // the first and last words of the row have a neighbor word missing, so are done by gol_packedword
+    size_t w = w0;
+    if (w == 0 && w < w1) {
+        out[0] = gol_packedword(up, mid, down, 0, words);
+        w++;
+    }
+    for (; w + 2 <= w1 && w + 2 < words; w += 2) {
+        uint64x2_t uw = GOL_NEON_WEST(up + w), uc = vld1q_u64(up + w), ue = GOL_NEON_EAST(up + w);
+        uint64x2_t mw = GOL_NEON_WEST(mid + w), mc = vld1q_u64(mid + w), me = GOL_NEON_EAST(mid + w);
+        uint64x2_t dw = GOL_NEON_WEST(down + w), dc = vld1q_u64(down + w), de = GOL_NEON_EAST(down + w);
+
+        uint64x2_t ux = veorq_u64(uw, uc), us = veorq_u64(ux, ue);
+        uint64x2_t uk = vorrq_u64(vandq_u64(uw, uc), vandq_u64(ue, ux));
+        uint64x2_t dx = veorq_u64(dw, dc), ds = veorq_u64(dx, de);
+        uint64x2_t dk = vorrq_u64(vandq_u64(dw, dc), vandq_u64(de, dx));
+        uint64x2_t ms = veorq_u64(mw, me), mk = vandq_u64(mw, me);
+
+        uint64x2_t sx = veorq_u64(us, ms), ones = veorq_u64(sx, ds);
+        uint64x2_t k = vorrq_u64(vandq_u64(us, ms), vandq_u64(ds, sx));
+        uint64x2_t tx = veorq_u64(uk, mk), t = veorq_u64(tx, dk);
+        uint64x2_t tk = vorrq_u64(vandq_u64(uk, mk), vandq_u64(dk, tx));
+        uint64x2_t twos = veorq_u64(t, k);
+        uint64x2_t high = vorrq_u64(tk, vandq_u64(t, k));
+
+        // vbicq(a, b) is a & ~b
+        vst1q_u64(out + w, vbicq_u64(vandq_u64(twos, vorrq_u64(ones, mc)), high));
+    }
+    for (; w < w1; w++)
+        out[w] = gol_packedword(up, mid, down, w, words);
+#undef GOL_NEON_WEST
+#undef GOL_NEON_EAST
+}
+#endif //GOL_KERNEL_NEON
+
+// The fixed size kernels tick whole packed boards of the sizes most jobs use, under conway's rule. gol_fixedrows is
+// instantiated for every size and boundary with constant arguments, so the loop over the words of a row is unrolled,
+// every stride is a constant and the torus wraps without a halo. With one word per row the compiler vectorizes across
+// the rows instead. Each set is compiled for the instruction set of the kernel it belongs to
+
+// always inlined, so every instantiation is compiled for the target of the kernel it's inlined into
+#if defined(__GNUC__)
+#define GOL_FIXED_INLINE inline __attribute__((always_inline))
+#else
+#define GOL_FIXED_INLINE inline
+#endif
+
+// PRIVATE
+// Ticks word w of a packed row, given the words west and east of it in each row
+static GOL_FIXED_INLINE uint64_t gol_fixedword(const uint64_t *up, const uint64_t *mid, const uint64_t *down, size_t w,
+                                               uint64_t ul, uint64_t ur, uint64_t ml, uint64_t mr, uint64_t dl,
+                                               uint64_t dr) {
+    return gol_wordnext((up[w] << 1) | (ul >> 63), up[w], (up[w] >> 1) | (ur << 63),
+                        (mid[w] << 1) | (ml >> 63), mid[w], (mid[w] >> 1) | (mr << 63),
+                        (down[w] << 1) | (dl >> 63), down[w], (down[w] >> 1) | (dr << 63));
+}
+
+// PRIVATE
+// Ticks one packed row of 'words' words, the west neighbor of the first word and the east neighbor of the last word
+// wrapping around the row on a torus, and dead otherwise
+static GOL_FIXED_INLINE void gol_fixedrow(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                                          size_t words, bool torus) {
+    const size_t end = words - 1;
+    if (words == 1) {
+        out[0] = torus ? gol_fixedword(up, mid, down, 0, up[0], up[0], mid[0], mid[0], down[0], down[0])
+                       : gol_fixedword(up, mid, down, 0, 0, 0, 0, 0, 0, 0);
+        return;
+    }
+    out[0] = gol_fixedword(up, mid, down, 0, torus ? up[end] : 0, up[1], torus ? mid[end] : 0, mid[1],
+                           torus ? down[end] : 0, down[1]);
+    // the words in between have both neighbors in the row. with a constant count, the compiler turns this into straight
+    // line vector code, rather than a loop
+    for (size_t w = 1; w < end; w++)
+        out[w] = gol_fixedword(up, mid, down, w, up[w - 1], up[w + 1], mid[w - 1], mid[w + 1],
+                               down[w - 1], down[w + 1]);
+    out[end] = gol_fixedword(up, mid, down, end, up[end - 1], torus ? up[0] : 0, mid[end - 1], torus ? mid[0] : 0,
+                             down[end - 1], torus ? down[0] : 0);
+}
+
+// PRIVATE
+// Ticks rows [y0, y1) of a packed board of 'rows' (at least 2) rows of 'words' words. Past the first and last row are
+// the opposite rows on a torus, and the zeroed row after the board otherwise
+static GOL_FIXED_INLINE void gol_fixedrows(const uint64_t *cells, uint64_t *next, gol_pos y0, gol_pos y1,
+                                           gol_pos rows, size_t words, bool torus) {
+    const uint64_t *last = cells + (size_t)(rows - 1) * words, *zero = cells + (size_t)rows * words;
+    const gol_pos end = y1 < rows - 1 ? y1 : rows - 1;
+    gol_pos y = y0;
+    if (y == 0 && y < y1) {
+        gol_fixedrow(torus ? last : zero, cells, cells + words, next, words, torus);
+        y++;
+    }
+    // every other row has both of its neighbors on the board, a constant stride away
+    for (; y < end; y++) {
+        const uint64_t *mid = cells + (size_t)y * words;
+        gol_fixedrow(mid - words, mid, mid + words, next + (size_t)y * words, words, torus);
+    }
+    if (y1 == rows && y < y1)
+        gol_fixedrow(last - words, last, torus ? cells : zero, next + (size_t)(rows - 1) * words, words, torus);
+}
+
+// PRIVATE
+// Defines gol_fixed_<name>, ticking a rows x (64 * words) board, compiled for 'target' (a target attribute, or nothing
+// for the baseline instruction set)
+#define GOL_FIXED_KERNEL(name, target, rows, words, torus) \
+    target static void gol_fixed_##name(const uint64_t *cells, uint64_t *next, gol_pos y0, gol_pos y1) { \
+        gol_fixedrows(cells, next, y0, y1, rows, words, torus); \
+    }
+
+// PRIVATE
+// Defines the fixed size kernels of one instruction set, and lists them for the kernel table
+#define GOL_FIXED_KERNELS(suffix, target) \
+    GOL_FIXED_KERNEL(64_dead##suffix, target, 64, 1, false) \
+    GOL_FIXED_KERNEL(64_torus##suffix, target, 64, 1, true) \
+    GOL_FIXED_KERNEL(256_dead##suffix, target, 256, 4, false) \
+    GOL_FIXED_KERNEL(256_torus##suffix, target, 256, 4, true) \
+    GOL_FIXED_KERNEL(1024_dead##suffix, target, 1024, 16, false) \
+    GOL_FIXED_KERNEL(1024_torus##suffix, target, 1024, 16, true) \
+    static const struct gol_fixed gol_fixed##suffix[] = { \
+            {64,   64,   GOL_BOUNDARY_DEAD,  gol_fixed_64_dead##suffix}, \
+            {64,   64,   GOL_BOUNDARY_TORUS, gol_fixed_64_torus##suffix}, \
+            {256,  256,  GOL_BOUNDARY_DEAD,  gol_fixed_256_dead##suffix}, \
+            {256,  256,  GOL_BOUNDARY_TORUS, gol_fixed_256_torus##suffix}, \
+            {1024, 1024, GOL_BOUNDARY_DEAD,  gol_fixed_1024_dead##suffix}, \
+            {1024, 1024, GOL_BOUNDARY_TORUS, gol_fixed_1024_torus##suffix}, \
+    };
+
+GOL_FIXED_KERNELS(_scalar, )
+#ifdef GOL_KERNEL_X86
+GOL_FIXED_KERNELS(_sse2, __attribute__((target("sse2"))))
+GOL_FIXED_KERNELS(_avx2, __attribute__((target("avx2"))))
+#endif
+
+#define GOL_FIXED_COUNT(table) (sizeof(table) / sizeof((table)[0]))
+
+// every kernel compiled in, from the least to the most preferred
+static const struct gol_kernel gol_kernels[] = {
+        {"scalar", gol_bytesrow_scalar, gol_packedrow_scalar, gol_bytesrule_scalar, gol_packedrule_scalar,
+                gol_bytescount_scalar, gol_packedcount_scalar, gol_bytespopulation_scalar, gol_packedpopulation_scalar,
+                gol_lanesrow_scalar, gol_fixed_scalar, GOL_FIXED_COUNT(gol_fixed_scalar)},
+#ifdef GOL_KERNEL_X86
+        {"sse2",   gol_bytesrow_sse2,   gol_packedrow_sse2,   gol_bytesrule_sse2,   gol_packedrule_scalar,
+                gol_bytescount_sse2,   gol_packedcount_sse2,   gol_bytespopulation_sse2,   gol_packedpopulation_sse2,
+                gol_lanesrow_sse2,   gol_fixed_sse2,   GOL_FIXED_COUNT(gol_fixed_sse2)},
+        {"avx2",   gol_bytesrow_avx2,   gol_packedrow_avx2,   gol_bytesrule_avx2,   gol_packedrule_avx2,
+                gol_bytescount_avx2,   gol_packedcount_avx2,   gol_bytespopulation_avx2,   gol_packedpopulation_avx2,
+                gol_lanesrow_avx2,   gol_fixed_avx2,   GOL_FIXED_COUNT(gol_fixed_avx2)},
+#endif
+#ifdef GOL_KERNEL_NEON
+        {"neon",   gol_bytesrow_neon,   gol_packedrow_neon,   gol_bytesrule_neon,   gol_packedrule_scalar,
+                gol_bytescount_scalar, gol_packedcount_scalar, gol_bytespopulation_scalar, gol_packedpopulation_scalar,
+                gol_lanesrow_scalar, gol_fixed_scalar, GOL_FIXED_COUNT(gol_fixed_scalar)},
+#endif
+};
+
+// the kernel picked by gol_kernel (or forced by gol_setkernel), NULL until the first tick. only ever accessed
+// atomically, since workers and simulation threads read it while gol_setkernel may write it
+static const struct gol_kernel *gol_active_kernel = NULL;
+
+// PRIVATE
+// Checks whether the cpu we are running on can execute the provided kernel
+static bool gol_kernel_supported(const struct gol_kernel *kernel) {
+#ifdef GOL_KERNEL_X86
+    if (strcmp(kernel->name, "sse2") == 0) return __builtin_cpu_supports("sse2");
+    if (strcmp(kernel->name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+#endif
+#ifdef GOL_KERNEL_NEON
+    if (strcmp(kernel->name, "neon") == 0) {
+#if defined(__linux__) && defined(__aarch64__)
+        return (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#elif defined(__linux__)
+        return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+        return true;
+#endif
+    }
+#endif
+    return true;
+}
+
+const struct gol_kernel *gol_kernel(void) {
+    const struct gol_kernel *kernel = __atomic_load_n(&gol_active_kernel, __ATOMIC_ACQUIRE);
+    if (kernel == NULL) {
+        // prefer the last supported kernel in the list. threads detecting it at the same time all pick the same one,
+        // and one that lost to gol_setkernel uses the forced kernel
+        const struct gol_kernel *best = &gol_kernels[0];
+        for (size_t i = 0; i < sizeof(gol_kernels) / sizeof(gol_kernels[0]); i++) {
+            if (gol_kernel_supported(&gol_kernels[i])) best = &gol_kernels[i];
+        }
+        // NULL is still expected, otherwise it's left holding the kernel that got there first
+        kernel = NULL;
+        if (__atomic_compare_exchange_n(&gol_active_kernel, &kernel, best, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            kernel = best;
+    }
+    return kernel;
+}
+
+const struct gol_fixed *gol_fixedkernel(const struct gol_kernel *kernel, gol_pos rows, gol_pos cols,
+                                        gol_boundary boundary) {
+    for (size_t i = 0; i < kernel->fixed_count; i++) {
+        const struct gol_fixed *fixed = &kernel->fixed[i];
+        if (fixed->rows == rows && fixed->cols == cols && fixed->boundary == boundary) return fixed;
+    }
+    return NULL;
+}
+
+// Provides the name of the tick kernel in use ("scalar", "sse2", "avx2" or "neon")
+// Returns: A static string, which must not be freed
+const char *gol_kernelname(void) {
+    return gol_kernel()->name;
+}
+
+// Forces the tick kernel with the provided name, or goes back to detecting the best one if name is NULL
+// Possible errors (return value): GOL_ERR_RANGE (unknown or unsupported kernel), GOL_ERR_OK
+gol_err gol_setkernel(const char *name) {
+    if (name == NULL) {
+        __atomic_store_n(&gol_active_kernel, NULL, __ATOMIC_RELEASE);
+        return GOL_ERR_OK;
+    }
+    for (size_t i = 0; i < sizeof(gol_kernels) / sizeof(gol_kernels[0]); i++) {
+        if (strcmp(gol_kernels[i].name, name) != 0) continue;
+        if (!gol_kernel_supported(&gol_kernels[i])) return GOL_ERR_RANGE;
+        __atomic_store_n(&gol_active_kernel, &gol_kernels[i], __ATOMIC_RELEASE);
+        return GOL_ERR_OK;
+    }
+    return GOL_ERR_RANGE;
+}
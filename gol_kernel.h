@@ -0,0 +1,190 @@
+#ifndef C_PLAYGROUND_GOL_KERNEL_H
+#define C_PLAYGROUND_GOL_KERNEL_H
+
+// PRIVATE
+// Row kernels used by gol_tick, shared between gol.c and gol_kernel.c. Not part of the public API.
+
+#include "gol.h"
+
+// computes 'count' cells of a byte board row into out[0..count), reading up/mid/down[-1..count]
+// every read is assumed to be on the board, so this is only used for the interior of a board
+typedef void (*gol_bytesrow_fn)(const bool *up, const bool *mid, const bool *down, bool *out, size_t count);
+// computes words [w0, w1) of a packed row of 'words' words into out, bits off either end of the row are dead
+typedef void (*gol_packedrow_fn)(const uint64_t *up, const uint64_t *mid, const uint64_t *down, uint64_t *out,
+                                 size_t w0, size_t w1, size_t words);
+// the same as the two above for any rule, instead of only B3/S23
+typedef void (*gol_bytesrule_fn)(const struct gol_rule *rule, const bool *up, const bool *mid, const bool *down,
+                                 bool *out, size_t count);
+typedef void (*gol_packedrule_fn)(const struct gol_rule *rule, const uint64_t *up, const uint64_t *mid,
+                                  const uint64_t *down, uint64_t *out, size_t w0, size_t w1, size_t words);
+// adds the live cells of 'count' cells (bytes) or words (packed) of a row before and after a tick to counts[0] and
+// counts[1], and the cells that changed to counts[2]
+typedef void (*gol_bytescount_fn)(const bool *before, const bool *after, size_t count, uint64_t counts[3]);
+typedef void (*gol_packedcount_fn)(const uint64_t *before, const uint64_t *after, size_t count, uint64_t counts[3]);
+// counts the live cells of 'count' cells (bytes) or words (packed)
+typedef uint64_t (*gol_bytespopulation_fn)(const bool *cells, size_t count);
+typedef uint64_t (*gol_packedpopulation_fn)(const uint64_t *words, size_t count);
+// the edges of the lanes of gol_lanesrow_fn: bits past 'mask' are dead, and the cells beyond the west and east edge of
+// a lane are the ones 'shift' columns back across it, masked with 'west' and 'east' (0 for dead cells there)
+struct gol_lanes {
+    uint64_t mask, west, east;
+    unsigned int shift;
+};
+// computes 'count' words of out under conway's rule, every word a row of a board of its own (a lane) rather than part
+// of one long row, so no cells cross from one word into another
+typedef void (*gol_lanesrow_fn)(const struct gol_lanes *lanes, const uint64_t *up, const uint64_t *mid,
+                                const uint64_t *down, uint64_t *out, size_t count);
+
+// ticks rows [y0, y1) of a packed board of one fixed size and boundary under conway's rule, reading 'cells' and writing
+// 'next' (both with the zeroed row after the board, see gol_allocboards). boundary modes other than dead are handled by
+// the kernel itself, so the halo isn't needed
+typedef void (*gol_fixedband_fn)(const uint64_t *cells, uint64_t *next, gol_pos y0, gol_pos y1);
+// a kernel specialized for boards of one size and boundary, whose sizes and strides are all compile-time constants
+struct gol_fixed {
+    gol_pos rows, cols;
+    gol_boundary boundary;
+    gol_fixedband_fn band;
+};
+
+struct gol_kernel {
+    const char *name;
+    // specialized for conway's rule
+    gol_bytesrow_fn bytesrow;
+    gol_packedrow_fn packedrow;
+    // any other rule, looked up in the rule's tables
+    gol_bytesrule_fn bytesrule;
+    gol_packedrule_fn packedrule;
+    // counting the cells of a row for gol_stats
+    gol_bytescount_fn bytescount;
+    gol_packedcount_fn packedcount;
+    // counting the live cells of a board, for gol_population
+    gol_bytespopulation_fn bytespopulation;
+    gol_packedpopulation_fn packedpopulation;
+    // the rows of a gol_batch
+    gol_lanesrow_fn lanesrow;
+    // whole packed boards of the common sizes, under conway's rule
+    const struct gol_fixed *fixed;
+    size_t fixed_count;
+};
+
+// B3/S23: a cell survives with 2 or 3 live neighbors and is reproduced with exactly 3
+extern const struct gol_rule gol_conway;
+
+// Sums the eight neighbor bits of every cell of a word (64 cells) of a packed row
+// 'up', 'mid' and 'down' are the rows above, at and below the word, each given as the word itself (c)
+// and its west (w) and east (e) neighbors already shifted so that every bit lines up with the cell it borders
+// The neighbor bits are added with full/half adders, so all 64 counts are computed at once. a count of 8 only sets
+// 'eights', every other count is ones + 2 * twos + 4 * fours
+static inline void gol_wordsum(uint64_t uw, uint64_t uc, uint64_t ue,
+                               uint64_t mw, uint64_t me,
+                               uint64_t dw, uint64_t dc, uint64_t de,
+                               uint64_t *ones, uint64_t *twos, uint64_t *fours, uint64_t *eights) {
+    // sum the three cells above and below (full adders), and the two beside (half adder)
+    uint64_t us = uw ^ uc ^ ue, uk = (uw & uc) | (ue & (uw ^ uc));
+    uint64_t ds = dw ^ dc ^ de, dk = (dw & dc) | (de & (dw ^ dc));
+    uint64_t ms = mw ^ me, mk = mw & me;
+
+    // ones bit of the count, carrying into the twos
+    *ones = us ^ ms ^ ds;
+    uint64_t k = (us & ms) | (ds & (us ^ ms));
+    // add the four carries of weight two: uk + mk + dk + k
+    uint64_t t = uk ^ mk ^ dk, tk = (uk & mk) | (dk & (uk ^ mk));
+    *twos = t ^ k;
+    *fours = tk ^ (t & k);
+    *eights = tk & t & k;
+}
+
+// Calculates the next generation of one word (64 cells) of a packed row under conway's rule
+// The arguments are the same as for gol_wordsum, plus the word itself (mc)
+// Returns: The next generation of the word
+static inline uint64_t gol_wordnext(uint64_t uw, uint64_t uc, uint64_t ue,
+                                    uint64_t mw, uint64_t mc, uint64_t me,
+                                    uint64_t dw, uint64_t dc, uint64_t de) {
+    uint64_t ones, twos, fours, eights;
+    gol_wordsum(uw, uc, ue, mw, me, dw, dc, de, &ones, &twos, &fours, &eights);
+    // a cell is alive next generation with exactly 3 neighbors, or with 2 neighbors if it's alive already
+    return twos & ~fours & ~eights & (ones | mc);
+}
+
+// Selects the cells of a word whose neighbor count (as summed by gol_wordsum) has its bit set in 'counts'
+static inline uint64_t gol_wordcounts(uint16_t counts, uint64_t ones, uint64_t twos, uint64_t fours, uint64_t eights) {
+    uint64_t cells = 0;
+    for (unsigned int n = 0; n <= 8; n++) {
+        if (!((counts >> n) & 1)) continue;
+        cells |= (n & 1 ? ones : ~ones) & (n & 2 ? twos : ~twos) & (n & 4 ? fours : ~fours)
+                 & (n & 8 ? eights : ~eights);
+    }
+    return cells;
+}
+
+// Calculates the next generation of one word (64 cells) of a packed row under any rule
+// The arguments are the same as for gol_wordsum, plus the word itself (mc)
+// Returns: The next generation of the word
+static inline uint64_t gol_wordrule(const struct gol_rule *rule,
+                                    uint64_t uw, uint64_t uc, uint64_t ue,
+                                    uint64_t mw, uint64_t mc, uint64_t me,
+                                    uint64_t dw, uint64_t dc, uint64_t de) {
+    uint64_t ones, twos, fours, eights;
+    gol_wordsum(uw, uc, ue, mw, me, dw, dc, de, &ones, &twos, &fours, &eights);
+    return (mc & gol_wordcounts(rule->survive, ones, twos, fours, eights))
+           | (~mc & gol_wordcounts(rule->birth, ones, twos, fours, eights));
+}
+
+// Counts the set bits of a word
+static inline unsigned int gol_popcount64(uint64_t word) {
+#if defined(__GNUC__)
+    return (unsigned int) __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (unsigned int) ((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Provides the index of the lowest set bit of a word, which must not be zero
+static inline unsigned int gol_lowbit64(uint64_t word) {
+    return gol_popcount64((word & -word) - 1);
+}
+
+// Provides the index of the highest set bit of a word, which must not be zero
+static inline unsigned int gol_highbit64(uint64_t word) {
+#if defined(__GNUC__)
+    return 63 - (unsigned int) __builtin_clzll(word);
+#else
+    unsigned int bit = 0;
+    while (word >>= 1) bit++;
+    return bit;
+#endif
+}
+
+// Counter-based random number generator: the output of splitmix64 for the state it reaches after 'counter' steps
+// from 'seed', so any word of the stream can be computed on its own, in any order and on any thread
+static inline uint64_t gol_random(uint64_t seed, uint64_t counter) {
+    uint64_t z = seed + (counter + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Provides 64 random cells, each alive with a probability of threshold / 2^GOL_FILL_BITS (below 1), from the random
+// words at 'counter' onwards. 'lowest' is the lowest bit set in threshold
+// Bit i of the density (from the lowest set bit up) either ORs (bit set) or ANDs (bit clear) in another random word,
+// so each cell ends up alive with exactly that probability
+static inline uint64_t gol_fillword(uint64_t seed, uint32_t threshold, unsigned int lowest, uint64_t counter) {
+    uint64_t cells = 0;
+    for (unsigned int bit = lowest; bit < GOL_FILL_BITS; bit++) {
+        uint64_t random = gol_random(seed, counter * GOL_FILL_BITS + bit);
+        cells = (threshold >> bit) & 1 ? cells | random : cells & random;
+    }
+    return cells;
+}
+
+// the kernel in use, picked on first use from the best instruction set the cpu supports. safe to call from any thread,
+// while another one calls gol_setkernel
+const struct gol_kernel *gol_kernel(void);
+// the fixed size kernel of 'kernel' for a packed rows x cols board with the provided boundary, NULL if there's none
+const struct gol_fixed *gol_fixedkernel(const struct gol_kernel *kernel, gol_pos rows, gol_pos cols,
+                                        gol_boundary boundary);
+
+#endif //C_PLAYGROUND_GOL_KERNEL_H
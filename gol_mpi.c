@@ -0,0 +1,538 @@
+#include "gol_mpi.h"
+#include "gol_kernel.h"
+#include "gol_alloc.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the column of the padded rows the block starts at, the halo west of it fills the top bits of the first word
+#define GOL_MPI_X0 64
+
+// the eight directions of the neighbors as (dx, dy): N, S, W, E, NW, NE, SW, SE
+static const int gol_mpi_dirs[8][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+// PRIVATE
+// Provides the direction opposite to d, the one a neighbor in direction d sends its edge to us in
+static inline int gol_mpi_opposite(int d) {
+    return d < 4 ? d ^ 1 : 11 - d;
+}
+
+// PRIVATE
+// Provides a pointer to row y of the padded block in a buffer
+static inline uint64_t *gol_mpi_row(const struct gol_mpi *mpi, uint64_t *buf, gol_pos y) {
+    return buf + (size_t)y * mpi->words;
+}
+
+// PRIVATE
+// Reads n (1 to 64) cells of a padded row from column x on
+static inline uint64_t gol_mpi_getbits(const uint64_t *row, gol_pos x, unsigned int n) {
+    size_t w = (size_t)x / 64;
+    unsigned int b = (unsigned int)x % 64;
+    uint64_t bits = row[w] >> b;
+    if (b != 0 && b + n > 64) bits |= row[w + 1] << (64 - b);
+    return n == 64 ? bits : bits & (((uint64_t)1 << n) - 1);
+}
+
+// PRIVATE
+// Writes n (1 to 64) cells of a padded row from column x on
+static inline void gol_mpi_setbits(uint64_t *row, gol_pos x, unsigned int n, uint64_t bits) {
+    size_t w = (size_t)x / 64;
+    unsigned int b = (unsigned int)x % 64;
+    const uint64_t mask = n == 64 ? ~(uint64_t)0 : ((uint64_t)1 << n) - 1;
+    bits &= mask;
+    row[w] = (row[w] & ~(mask << b)) | (bits << b);
+    if (b != 0 && b + n > 64) row[w + 1] = (row[w + 1] & ~(mask >> (64 - b))) | (bits >> (64 - b));
+}
+
+// a rectangle of the padded block, columns [x0, x1) and rows [y0, y1)
+struct gol_mpi_rect {
+    gol_pos x0, x1, y0, y1;
+};
+
+// PRIVATE
+// Provides the rectangle of the edge of the block sent to the neighbor in direction d or, with 'halo', the rectangle
+// of the halo received from it
+static struct gol_mpi_rect gol_mpi_edge(const struct gol_mpi *mpi, int d, bool halo) {
+    const gol_pos k = mpi->depth, x0 = GOL_MPI_X0, y0 = k;
+    const int dx = gol_mpi_dirs[d][0], dy = gol_mpi_dirs[d][1];
+    struct gol_mpi_rect rect;
+    if (halo) {
+        rect.x0 = dx < 0 ? x0 - k : (dx == 0 ? x0 : x0 + mpi->w);
+        rect.x1 = dx < 0 ? x0 : (dx == 0 ? x0 + mpi->w : x0 + mpi->w + k);
+        rect.y0 = dy < 0 ? y0 - k : (dy == 0 ? y0 : y0 + mpi->h);
+        rect.y1 = dy < 0 ? y0 : (dy == 0 ? y0 + mpi->h : y0 + mpi->h + k);
+    } else {
+        rect.x0 = dx <= 0 ? x0 : x0 + mpi->w - k;
+        rect.x1 = dx < 0 ? x0 + k : x0 + mpi->w;
+        rect.y0 = dy <= 0 ? y0 : y0 + mpi->h - k;
+        rect.y1 = dy < 0 ? y0 + k : y0 + mpi->h;
+    }
+    return rect;
+}
+
+// PRIVATE
+// Provides the number of words a rectangle packs into, every row of it starting on a new word
+static inline size_t gol_mpi_rectwords(struct gol_mpi_rect rect) {
+    return (size_t)(rect.y1 - rect.y0) * (((size_t)(rect.x1 - rect.x0) + 63) / 64);
+}
+
+// PRIVATE
+// Packs the cells of a rectangle of a buffer into 'out'
+static void gol_mpi_pack(const struct gol_mpi *mpi, uint64_t *buf, struct gol_mpi_rect rect, uint64_t *out) {
+    for (gol_pos y = rect.y0; y < rect.y1; y++) {
+        const uint64_t *row = gol_mpi_row(mpi, buf, y);
+        for (gol_pos x = rect.x0; x < rect.x1; x += 64)
+            *out++ = gol_mpi_getbits(row, x, rect.x1 - x < 64 ? (unsigned int)(rect.x1 - x) : 64);
+    }
+}
+
+// PRIVATE
+// Unpacks cells packed by gol_mpi_pack into a rectangle of a buffer, or kills the rectangle if 'in' is NULL
+static void gol_mpi_unpack(const struct gol_mpi *mpi, uint64_t *buf, struct gol_mpi_rect rect, const uint64_t *in) {
+    for (gol_pos y = rect.y0; y < rect.y1; y++) {
+        uint64_t *row = gol_mpi_row(mpi, buf, y);
+        for (gol_pos x = rect.x0; x < rect.x1; x += 64)
+            gol_mpi_setbits(row, x, rect.x1 - x < 64 ? (unsigned int)(rect.x1 - x) : 64, in != NULL ? *in++ : 0);
+    }
+}
+
+// PRIVATE
+// Kills the halo past every dead edge of the board, the cells there have to stay dead whatever a tick computed
+static void gol_mpi_clearhalo(const struct gol_mpi *mpi, uint64_t *buf) {
+    for (int d = 0; d < 8; d++) {
+        if (mpi->neighbors[d] == MPI_PROC_NULL) gol_mpi_unpack(mpi, buf, gol_mpi_edge(mpi, d, true), NULL);
+    }
+}
+
+// PRIVATE
+// Provides the block of the rank at the provided coordinates in the grid of ranks
+static void gol_mpi_block(const struct gol_mpi *mpi, const int coords[2], gol_pos *x, gol_pos *y, gol_pos *w,
+                          gol_pos *h) {
+    *y = mpi->rows * coords[0] / mpi->dims[0];
+    *h = mpi->rows * (coords[0] + 1) / mpi->dims[0] - *y;
+    *x = mpi->cols * coords[1] / mpi->dims[1];
+    *w = mpi->cols * (coords[1] + 1) / mpi->dims[1] - *x;
+}
+
+// PRIVATE
+// Provides the number of words the block of this rank packs into or, on rank 0, the largest block of any rank
+static size_t gol_mpi_blockwords(const struct gol_mpi *mpi) {
+    size_t words = (size_t)mpi->h * (((size_t)mpi->w + 63) / 64);
+    for (int rank = 1; mpi->rank == 0 && rank < mpi->size; rank++) {
+        int coords[2];
+        gol_pos x, y, w, h;
+        MPI_Cart_coords(mpi->comm, rank, 2, coords);
+        gol_mpi_block(mpi, coords, &x, &y, &w, &h);
+        size_t count = (size_t)h * (((size_t)w + 63) / 64);
+        if (count > words) words = count;
+    }
+    return words;
+}
+
+// PRIVATE
+// Agrees with every other rank of the grid on how a step went, the highest error any rank ran into, so all of them
+// return from a collective call together, instead of some waiting for messages a failed rank never sends
+// Possible errors (return value): the error of any rank, GOL_ERR_IO (MPI failed), GOL_ERR_OK
+static gol_err gol_mpi_agree(MPI_Comm comm, gol_err error) {
+    int local = (int)error, worst;
+    if (MPI_Allreduce(&local, &worst, 1, MPI_INT, MPI_MAX, comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    return (gol_err)worst;
+}
+
+// PRIVATE
+// Provides the rank owning the cell at column x, row y of the board
+static int gol_mpi_owner(const struct gol_mpi *mpi, gol_pos x, gol_pos y) {
+    int coords[2] = {0, 0}, rank;
+    while (mpi->rows * (coords[0] + 1) / mpi->dims[0] <= y) coords[0]++;
+    while (mpi->cols * (coords[1] + 1) / mpi->dims[1] <= x) coords[1]++;
+    MPI_Cart_rank(mpi->comm, coords, &rank);
+    return rank;
+}
+
+// Splits a rows x cols board across the ranks of comm, every rank getting a block of rows / dims[0] x cols / dims[1]
+// cells (give or take one) of a grid of ranks as square as possible
+// Possible errors (return value): GOL_ERR_RANGE (a size below 1, a mirrored boundary, an invalid rule, or a halo deeper
+// than GOL_MPI_MAX_DEPTH or than a block), GOL_ERR_NOMEM, GOL_ERR_IO (MPI failed), GOL_ERR_OK
+gol_err gol_mpi_init(struct gol_mpi *mpi, MPI_Comm comm, gol_pos rows, gol_pos cols, const struct gol_options *opts,
+                     unsigned int depth) {
+    gol_err error;
+    memset(mpi, 0, sizeof(struct gol_mpi));
+    mpi->comm = MPI_COMM_NULL;
+    if (rows < 1 || cols < 1) return GOL_ERR_RANGE;
+    mpi->rows = rows;
+    mpi->cols = cols;
+    mpi->boundary = opts != NULL ? opts->boundary : GOL_BOUNDARY_DEAD;
+    if (mpi->boundary != GOL_BOUNDARY_DEAD && mpi->boundary != GOL_BOUNDARY_TORUS) return GOL_ERR_RANGE;
+    const char *rule = opts != NULL && opts->rule != NULL ? opts->rule : GOL_RULE_CONWAY;
+    if ((error = gol_parserule(rule, &mpi->rule)) != GOL_ERR_OK) return error;
+    mpi->depth = depth > 0 ? depth : 1;
+    if (mpi->depth > GOL_MPI_MAX_DEPTH) return GOL_ERR_RANGE;
+    if ((error = gol_allocator_init(&mpi->allocator, opts != NULL ? opts->allocator : NULL)) != GOL_ERR_OK) return error;
+
+    // lay the ranks out in a grid, with more blocks along the longer side of the board
+    int size;
+    if (MPI_Comm_size(comm, &size) != MPI_SUCCESS) return GOL_ERR_IO;
+    int dims[2] = {0, 0};
+    if (MPI_Dims_create(size, 2, dims) != MPI_SUCCESS) return GOL_ERR_IO;
+    mpi->dims[0] = rows >= cols ? dims[0] : dims[1];
+    mpi->dims[1] = rows >= cols ? dims[1] : dims[0];
+    // the smallest block is rows / dims[0] x cols / dims[1], the same on every rank
+    if (rows / mpi->dims[0] < (gol_pos)mpi->depth || cols / mpi->dims[1] < (gol_pos)mpi->depth) return GOL_ERR_RANGE;
+
+    const int periods[2] = {mpi->boundary == GOL_BOUNDARY_TORUS, mpi->boundary == GOL_BOUNDARY_TORUS};
+    if (MPI_Cart_create(comm, 2, mpi->dims, periods, 0, &mpi->comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    MPI_Comm_rank(mpi->comm, &mpi->rank);
+    MPI_Comm_size(mpi->comm, &mpi->size);
+    MPI_Cart_coords(mpi->comm, mpi->rank, 2, mpi->coords);
+    gol_mpi_block(mpi, mpi->coords, &mpi->x, &mpi->y, &mpi->w, &mpi->h);
+
+    for (int d = 0; d < 8; d++) {
+        int at[2] = {mpi->coords[0] + gol_mpi_dirs[d][1], mpi->coords[1] + gol_mpi_dirs[d][0]};
+        bool outside = at[0] < 0 || at[0] >= mpi->dims[0] || at[1] < 0 || at[1] >= mpi->dims[1];
+        mpi->neighbors[d] = MPI_PROC_NULL;
+        if (!outside || mpi->boundary == GOL_BOUNDARY_TORUS) MPI_Cart_rank(mpi->comm, at, &mpi->neighbors[d]);
+    }
+
+    // the block and its halo, padded to a word on the west so the block starts on one
+    mpi->prows = mpi->h + 2 * (gol_pos)mpi->depth;
+    mpi->words = ((size_t)(GOL_MPI_X0 + mpi->w + mpi->depth) + 63) / 64;
+    // a gather sends a whole block in one message, whose size is an int
+    error = GOL_ERR_OK;
+    if ((size_t)mpi->h * (((size_t)mpi->w + 63) / 64) > INT_MAX) error = GOL_ERR_RANGE;
+    if (error == GOL_ERR_OK) {
+        mpi->cells = (uint64_t *) gol_zalloc(&mpi->allocator, (size_t)mpi->prows * mpi->words, sizeof(uint64_t));
+        mpi->next = (uint64_t *) gol_zalloc(&mpi->allocator, (size_t)mpi->prows * mpi->words, sizeof(uint64_t));
+
+        // the edge sent in every direction has the shape of the halo received from the opposite one
+        size_t offset = 0;
+        for (int d = 0; d < 8; d++) {
+            mpi->offsets[d] = offset;
+            offset += gol_mpi_rectwords(gol_mpi_edge(mpi, d, true));
+        }
+        mpi->offsets[8] = offset;
+        mpi->sendbuf = (uint64_t *) gol_alloc(&mpi->allocator, offset, sizeof(uint64_t));
+        mpi->recvbuf = (uint64_t *) gol_alloc(&mpi->allocator, offset, sizeof(uint64_t));
+        if (mpi->cells == NULL || mpi->next == NULL || mpi->sendbuf == NULL || mpi->recvbuf == NULL)
+            error = GOL_ERR_NOMEM;
+    }
+    // the blocks differ in size, so one rank alone may fail: either all of them get a board or none does
+    if ((error = gol_mpi_agree(mpi->comm, error)) != GOL_ERR_OK) {
+        gol_mpi_free(mpi);
+        return error;
+    }
+    return GOL_ERR_OK;
+}
+
+// Releases the block of this rank and the communicator of the grid of ranks
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_mpi_free(struct gol_mpi *mpi) {
+    if (mpi->cells)
+        gol_dealloc(&mpi->allocator, mpi->cells);
+    if (mpi->next)
+        gol_dealloc(&mpi->allocator, mpi->next);
+    if (mpi->sendbuf)
+        gol_dealloc(&mpi->allocator, mpi->sendbuf);
+    if (mpi->recvbuf)
+        gol_dealloc(&mpi->allocator, mpi->recvbuf);
+    if (mpi->comm != MPI_COMM_NULL)
+        MPI_Comm_free(&mpi->comm);
+    memset(mpi, 0, sizeof(struct gol_mpi));
+    mpi->comm = MPI_COMM_NULL;
+    return GOL_ERR_OK;
+}
+
+// Reads the cell at column x, row y of the board, which its owner broadcasts to every rank
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_getcell(const struct gol_mpi *mpi, gol_pos x, gol_pos y, bool *alive) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    if (x < 0 || x >= mpi->cols || y < 0 || y >= mpi->rows) return GOL_ERR_RANGE;
+
+    int owner = gol_mpi_owner(mpi, x, y);
+    unsigned char cell = 0;
+    if (owner == mpi->rank) {
+        const uint64_t *row = gol_mpi_row(mpi, mpi->cells, y - mpi->y + (gol_pos)mpi->depth);
+        cell = (unsigned char)gol_mpi_getbits(row, GOL_MPI_X0 + x - mpi->x, 1);
+    }
+    if (MPI_Bcast(&cell, 1, MPI_UNSIGNED_CHAR, owner, mpi->comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    *alive = cell != 0;
+    return GOL_ERR_OK;
+}
+
+// Sets the cell at column x, row y of the board on the rank owning it
+// The halos are exchanged again on the next tick, the neighbors of the cell may hold it in theirs
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_OK
+gol_err gol_mpi_setcell(struct gol_mpi *mpi, gol_pos x, gol_pos y, bool alive) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    if (x < 0 || x >= mpi->cols || y < 0 || y >= mpi->rows) return GOL_ERR_RANGE;
+
+    if (x >= mpi->x && x < mpi->x + mpi->w && y >= mpi->y && y < mpi->y + mpi->h) {
+        uint64_t *row = gol_mpi_row(mpi, mpi->cells, y - mpi->y + (gol_pos)mpi->depth);
+        gol_mpi_setbits(row, GOL_MPI_X0 + x - mpi->x, 1, alive);
+    }
+    mpi->phase = 0;
+    return GOL_ERR_OK;
+}
+
+// Populates the board with random cells, each alive with a probability of 'density' (from 0 to 1)
+// Every rank draws the words of the stream of gol_populate_seeded its block overlaps, so the ranks never communicate
+// and the board is the same as gol_populate_seeded gives a single board, however it's split
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (density not within [0, 1]), GOL_ERR_OK
+gol_err gol_mpi_populate_seeded(struct gol_mpi *mpi, uint64_t seed, double density) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    // also catches NaN
+    if (!(density >= 0.0 && density <= 1.0)) return GOL_ERR_RANGE;
+
+    uint32_t threshold = (uint32_t) (density * (double) (1u << GOL_FILL_BITS) + 0.5);
+    unsigned int lowest = 0;
+    while (lowest < GOL_FILL_BITS && !((threshold >> lowest) & 1))
+        lowest++;
+
+    const size_t words = ((size_t)mpi->cols + 63) / 64;
+    memset(mpi->cells, 0, (size_t)mpi->prows * mpi->words * sizeof(uint64_t));
+    for (gol_pos r = 0; r < mpi->h; r++) {
+        uint64_t *row = gol_mpi_row(mpi, mpi->cells, r + (gol_pos)mpi->depth);
+        gol_pos y = mpi->y + r;
+        for (size_t g = (size_t)mpi->x / 64; g <= (size_t)(mpi->x + mpi->w - 1) / 64; g++) {
+            uint64_t cells = threshold >> GOL_FILL_BITS
+                             ? ~(uint64_t)0
+                             : gol_fillword(seed, threshold, lowest, (size_t)y * words + g);
+            // the part of global word g within the block
+            gol_pos x0 = (gol_pos)g * 64 > mpi->x ? (gol_pos)g * 64 : mpi->x;
+            gol_pos x1 = (gol_pos)g * 64 + 64 < mpi->x + mpi->w ? (gol_pos)g * 64 + 64 : mpi->x + mpi->w;
+            gol_mpi_setbits(row, GOL_MPI_X0 + x0 - mpi->x, (unsigned int)(x1 - x0), cells >> (x0 - (gol_pos)g * 64));
+        }
+    }
+    mpi->phase = 0;
+    return GOL_ERR_OK;
+}
+
+// Provides the number of live cells of the whole board, summed over the blocks of all ranks
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_population(const struct gol_mpi *mpi, uint64_t *population) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    uint64_t local = 0;
+    for (gol_pos r = 0; r < mpi->h; r++) {
+        const uint64_t *row = gol_mpi_row(mpi, mpi->cells, r + (gol_pos)mpi->depth);
+        for (gol_pos x = 0; x < mpi->w; x += 64) {
+            unsigned int n = mpi->w - x < 64 ? (unsigned int)(mpi->w - x) : 64;
+            local += gol_popcount64(gol_mpi_getbits(row, GOL_MPI_X0 + x, n));
+        }
+    }
+    if (MPI_Allreduce(&local, population, 1, MPI_UINT64_T, MPI_SUM, mpi->comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    return GOL_ERR_OK;
+}
+
+// Replaces the board with the cells of a rows x cols game on rank 0, which sends every other rank its block
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (the game on rank 0 isn't the size of the board),
+// GOL_ERR_NOMEM, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_scatter(struct gol_mpi *mpi, const struct gameoflife *game) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    // rank 0 decides for everyone whether the game fits
+    int error = GOL_ERR_OK;
+    if (mpi->rank == 0 && (game == NULL || game->rows != mpi->rows || game->cols != mpi->cols)) error = GOL_ERR_RANGE;
+    if (MPI_Bcast(&error, 1, MPI_INT, 0, mpi->comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    if (error != GOL_ERR_OK) return (gol_err)error;
+
+    const struct gol_mpi_rect block = {GOL_MPI_X0, GOL_MPI_X0 + mpi->w, mpi->depth, mpi->depth + mpi->h};
+    // every rank allocates its buffer up front (rank 0 one for the largest block) and they agree on it before any
+    // message, so a rank failing doesn't leave others blocked on a send or receive
+    size_t count = gol_mpi_blockwords(mpi);
+    uint64_t *buf = (uint64_t *) gol_alloc(&mpi->allocator, count, sizeof(uint64_t));
+    if ((error = gol_mpi_agree(mpi->comm, buf != NULL ? GOL_ERR_OK : GOL_ERR_NOMEM)) != GOL_ERR_OK) {
+        gol_dealloc(&mpi->allocator, buf);
+        return (gol_err)error;
+    }
+
+    if (mpi->rank != 0) {
+        int result = MPI_Recv(buf, (int)count, MPI_UINT64_T, 0, 0, mpi->comm, MPI_STATUS_IGNORE);
+        if (result == MPI_SUCCESS) gol_mpi_unpack(mpi, mpi->cells, block, buf);
+        gol_dealloc(&mpi->allocator, buf);
+        if (result != MPI_SUCCESS) return GOL_ERR_IO;
+        mpi->phase = 0;
+        return GOL_ERR_OK;
+    }
+
+    for (int rank = 0; rank < mpi->size; rank++) {
+        int coords[2];
+        gol_pos x, y, w, h;
+        MPI_Cart_coords(mpi->comm, rank, 2, coords);
+        gol_mpi_block(mpi, coords, &x, &y, &w, &h);
+        count = (size_t)h * (((size_t)w + 63) / 64);
+        uint64_t *out = buf;
+        memset(out, 0, count * sizeof(uint64_t));
+        uint64_t *word = out;
+        for (gol_pos r = 0; r < h; r++) {
+            for (gol_pos c = 0; c < w; c++) {
+                bool alive;
+                gol_getcell(game, x + c, y + r, &alive);
+                word[c / 64] |= (uint64_t)alive << (c % 64);
+            }
+            word += ((size_t)w + 63) / 64;
+        }
+        int result = MPI_SUCCESS;
+        if (rank == 0)
+            gol_mpi_unpack(mpi, mpi->cells, block, out);
+        else
+            result = MPI_Send(out, (int)count, MPI_UINT64_T, rank, 0, mpi->comm);
+        if (result != MPI_SUCCESS) {
+            gol_dealloc(&mpi->allocator, buf);
+            return GOL_ERR_IO;
+        }
+    }
+    gol_dealloc(&mpi->allocator, buf);
+    mpi->phase = 0;
+    return GOL_ERR_OK;
+}
+
+// Writes the whole board into a rows x cols game on rank 0, every other rank sends it its block
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (the game on rank 0 isn't the size of the board),
+// GOL_ERR_NOMEM, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_gather(const struct gol_mpi *mpi, struct gameoflife *game) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+    int error = GOL_ERR_OK;
+    if (mpi->rank == 0 && (game == NULL || game->rows != mpi->rows || game->cols != mpi->cols)) error = GOL_ERR_RANGE;
+    if (MPI_Bcast(&error, 1, MPI_INT, 0, mpi->comm) != MPI_SUCCESS) return GOL_ERR_IO;
+    if (error != GOL_ERR_OK) return (gol_err)error;
+
+    const struct gol_mpi_rect block = {GOL_MPI_X0, GOL_MPI_X0 + mpi->w, mpi->depth, mpi->depth + mpi->h};
+    // as in a scatter, the ranks agree on their buffers before any message
+    size_t count = gol_mpi_blockwords(mpi);
+    uint64_t *buf = (uint64_t *) gol_alloc(&mpi->allocator, count, sizeof(uint64_t));
+    if ((error = gol_mpi_agree(mpi->comm, buf != NULL ? GOL_ERR_OK : GOL_ERR_NOMEM)) != GOL_ERR_OK) {
+        gol_dealloc(&mpi->allocator, buf);
+        return (gol_err)error;
+    }
+
+    if (mpi->rank != 0) {
+        gol_mpi_pack(mpi, mpi->cells, block, buf);
+        int result = MPI_Send(buf, (int)count, MPI_UINT64_T, 0, 0, mpi->comm);
+        gol_dealloc(&mpi->allocator, buf);
+        return result == MPI_SUCCESS ? GOL_ERR_OK : GOL_ERR_IO;
+    }
+
+    // the other ranks send their blocks anyway, so receive them all even if the game can't take them
+    error = gol_clear(game);
+    for (int rank = 0; rank < mpi->size; rank++) {
+        int coords[2];
+        gol_pos x, y, w, h;
+        MPI_Cart_coords(mpi->comm, rank, 2, coords);
+        gol_mpi_block(mpi, coords, &x, &y, &w, &h);
+        count = (size_t)h * (((size_t)w + 63) / 64);
+        uint64_t *in = buf;
+        if (rank == 0) {
+            gol_mpi_pack(mpi, mpi->cells, block, in);
+        } else if (MPI_Recv(in, (int)count, MPI_UINT64_T, rank, 0, mpi->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+            gol_dealloc(&mpi->allocator, buf);
+            return GOL_ERR_IO;
+        }
+        if (error != GOL_ERR_OK) continue;
+
+        // write every run of live cells of the block at once
+        const uint64_t *word = in;
+        for (gol_pos r = 0; r < h; r++, word += ((size_t)w + 63) / 64) {
+            for (gol_pos c = 0; c < w;) {
+                if (!((word[c / 64] >> (c % 64)) & 1)) {
+                    c++;
+                    continue;
+                }
+                gol_pos end = c;
+                while (end < w && ((word[end / 64] >> (end % 64)) & 1)) end++;
+                gol_setrun(game, x + c, y + r, end - c, true);
+                c = end;
+            }
+        }
+    }
+    gol_dealloc(&mpi->allocator, buf);
+    return (gol_err)error;
+}
+
+// PRIVATE
+// Ticks rows [y0, y1) of the padded block, words [w0, w1) of every row, from 'cells' into 'next'
+static void gol_mpi_rows(const struct gol_mpi *mpi, gol_pos y0, gol_pos y1, size_t w0, size_t w1) {
+    if (w0 >= w1) return;
+    const struct gol_kernel *kernel = gol_kernel();
+    for (gol_pos y = y0; y < y1; y++) {
+        const uint64_t *up = gol_mpi_row(mpi, mpi->cells, y - 1), *mid = gol_mpi_row(mpi, mpi->cells, y);
+        const uint64_t *down = gol_mpi_row(mpi, mpi->cells, y + 1);
+        uint64_t *out = gol_mpi_row(mpi, mpi->next, y);
+        if (mpi->rule.conway)
+            kernel->packedrow(up, mid, down, out, w0, w1, mpi->words);
+        else
+            kernel->packedrule(&mpi->rule, up, mid, down, out, w0, w1, mpi->words);
+    }
+}
+
+// Ticks the board forward one generation
+// Right after an exchange the halo is correct 'depth' cells out, every generation computes one cell less of it, so the
+// halos only need exchanging every 'depth' generations. the first generation after it ticks the interior of the block
+// (which doesn't need the halo) while the messages are in flight, and the edges once they arrived
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_tick(struct gol_mpi *mpi) {
+    if (mpi->cells == NULL) return GOL_ERR_INIT;
+
+    // the cells still correct this generation: the block and 'margin' cells of the halo around it
+    const gol_pos k = mpi->depth, margin = k - 1 - (gol_pos)mpi->phase;
+    const gol_pos y0 = k - margin, y1 = k + mpi->h + margin;
+    const size_t w0 = (size_t)(GOL_MPI_X0 - margin) / 64, w1 = (size_t)(GOL_MPI_X0 + mpi->w + margin + 63) / 64;
+
+    if (mpi->phase > 0) {
+        gol_mpi_rows(mpi, y0, y1, w0, w1);
+    } else {
+        MPI_Request requests[16];
+        for (int d = 0; d < 8; d++) {
+            // direction d's neighbor sends its edge towards the opposite direction, tagged with that direction
+            size_t count = mpi->offsets[d + 1] - mpi->offsets[d];
+            MPI_Irecv(mpi->recvbuf + mpi->offsets[d], (int)count, MPI_UINT64_T, mpi->neighbors[d],
+                      gol_mpi_opposite(d), mpi->comm, &requests[d]);
+        }
+        for (int d = 0; d < 8; d++) {
+            // sent edges have the shape of the opposite halo, so use the offsets of the opposite direction
+            int o = gol_mpi_opposite(d);
+            gol_mpi_pack(mpi, mpi->cells, gol_mpi_edge(mpi, d, false), mpi->sendbuf + mpi->offsets[o]);
+            MPI_Isend(mpi->sendbuf + mpi->offsets[o], (int)(mpi->offsets[o + 1] - mpi->offsets[o]), MPI_UINT64_T,
+                      mpi->neighbors[d], d, mpi->comm, &requests[8 + d]);
+        }
+
+        // the interior: rows and words of the block whose neighbors are all in the block
+        const gol_pos iy0 = k + 1, iy1 = k + mpi->h - 1;
+        const size_t iw0 = 2, iw1 = (size_t)(GOL_MPI_X0 + mpi->w - 1) / 64;
+        const bool interior = iy0 < iy1 && iw0 < iw1;
+        if (interior) gol_mpi_rows(mpi, iy0, iy1, iw0, iw1);
+
+        if (MPI_Waitall(16, requests, MPI_STATUSES_IGNORE) != MPI_SUCCESS) return GOL_ERR_IO;
+        for (int d = 0; d < 8; d++) {
+            if (mpi->neighbors[d] != MPI_PROC_NULL)
+                gol_mpi_unpack(mpi, mpi->cells, gol_mpi_edge(mpi, d, true), mpi->recvbuf + mpi->offsets[d]);
+        }
+        gol_mpi_clearhalo(mpi, mpi->cells);
+
+        if (interior) {
+            gol_mpi_rows(mpi, y0, iy0, w0, w1);
+            gol_mpi_rows(mpi, iy0, iy1, w0, iw0);
+            gol_mpi_rows(mpi, iy0, iy1, iw1, w1);
+            gol_mpi_rows(mpi, iy1, y1, w0, w1);
+        } else {
+            gol_mpi_rows(mpi, y0, y1, w0, w1);
+        }
+    }
+    // the halo past a dead edge was ticked along with the rest, but has to stay dead for the next generation
+    if (margin > 0) gol_mpi_clearhalo(mpi, mpi->next);
+
+    uint64_t *next = mpi->next;
+    mpi->next = mpi->cells;
+    mpi->cells = next;
+    mpi->phase = (mpi->phase + 1) % mpi->depth;
+    mpi->generation++;
+    return GOL_ERR_OK;
+}
+
+// Ticks the board forward n generations
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_mpi_tick_n(struct gol_mpi *mpi, unsigned long n) {
+    gol_err error;
+    for (unsigned long i = 0; i < n; i++) {
+        if ((error = gol_mpi_tick(mpi)) != GOL_ERR_OK) return error;
+    }
+    return GOL_ERR_OK;
+}
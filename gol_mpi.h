@@ -0,0 +1,75 @@
+#ifndef C_PLAYGROUND_GOL_MPI_H
+#define C_PLAYGROUND_GOL_MPI_H
+
+#include "gol.h"
+
+#include <mpi.h>
+
+// Distributed board: the rows x cols grid is split into a 2D grid of blocks, one per rank of an MPI communicator, so a
+// board can be larger than the memory of any single machine. every rank keeps its block bit-packed, surrounded by a
+// halo 'depth' cells deep which is exchanged with the eight neighboring blocks every 'depth' generations. a deeper halo
+// trades a little more computation for fewer, larger messages.
+// every function is collective: all ranks of the communicator must make the same calls with the same arguments. a
+// failure one rank runs into (like running out of memory) is returned on every rank, except MPI itself failing
+
+// deepest halo gol_mpi_init accepts
+#define GOL_MPI_MAX_DEPTH 64
+
+struct gol_mpi {
+    MPI_Comm comm;
+    int rank, size;
+    // the grid of ranks (rows and columns of blocks), the position of this rank in it, and the ranks of the eight
+    // neighboring blocks (N, S, W, E, NW, NE, SW, SE), MPI_PROC_NULL past a dead edge
+    int dims[2], coords[2];
+    int neighbors[8];
+
+    gol_pos rows, cols;
+    gol_boundary boundary;
+    struct gol_rule rule;
+    uint64_t generation;
+
+    // the block of this rank: columns [x, x + w) and rows [y, y + h) of the board
+    gol_pos x, y, w, h;
+    // depth of the halo, and the generations ticked since the last exchange
+    unsigned int depth;
+    unsigned int phase;
+    // the block with its halo, 'prows' rows of 'words' words. row depth + r is row r of the block, whose column c is
+    // bit 64 + c of the row (the halo west of it is the top bits of the first word)
+    gol_pos prows;
+    size_t words;
+    uint64_t *cells;
+    uint64_t *next;
+    // the packed edges going to and coming from every neighbor, at offsets[d] for direction d in both buffers
+    uint64_t *sendbuf;
+    uint64_t *recvbuf;
+    size_t offsets[9];
+    // where all of the buffers above come from (gol_options.allocator)
+    struct gol_allocator allocator;
+};
+
+// splits a rows x cols board across the ranks of comm. opts->rule, boundary and allocator apply like they do to
+// gol_init_opts (GOL_BOUNDARY_DEAD and GOL_BOUNDARY_TORUS only), opts can be NULL for the defaults. depth is the depth
+// of the halo (0 for 1), each block must be at least that many cells wide and high
+gol_err gol_mpi_init(struct gol_mpi *mpi, MPI_Comm comm, gol_pos rows, gol_pos cols, const struct gol_options *opts,
+                     unsigned int depth);
+// releases the block of this rank (except for the provided pointer itself)
+gol_err gol_mpi_free(struct gol_mpi *mpi);
+// reads the cell at column x, row y of the board into 'alive' on every rank
+gol_err gol_mpi_getcell(const struct gol_mpi *mpi, gol_pos x, gol_pos y, bool *alive);
+// sets the cell at column x, row y of the board
+gol_err gol_mpi_setcell(struct gol_mpi *mpi, gol_pos x, gol_pos y, bool alive);
+// populates the board with exactly the cells gol_populate_seeded gives a single rows x cols board
+gol_err gol_mpi_populate_seeded(struct gol_mpi *mpi, uint64_t seed, double density);
+// provides the number of live cells of the whole board on every rank
+gol_err gol_mpi_population(const struct gol_mpi *mpi, uint64_t *population);
+// replaces the board with the cells of 'game', which is only read on rank 0 (and can be NULL on the others)
+gol_err gol_mpi_scatter(struct gol_mpi *mpi, const struct gameoflife *game);
+// writes the whole board into 'game' on rank 0, which must be rows x cols (and can be NULL on the other ranks)
+// gol_tostring, gol_render or gol_snapshot_write on rank 0 then output the distributed board
+gol_err gol_mpi_gather(const struct gol_mpi *mpi, struct gameoflife *game);
+// ticks the board forward one generation
+gol_err gol_mpi_tick(struct gol_mpi *mpi);
+// ticks the board forward n generations
+gol_err gol_mpi_tick_n(struct gol_mpi *mpi, unsigned long n);
+
+#endif //C_PLAYGROUND_GOL_MPI_H
@@ -0,0 +1,174 @@
+#include "gol_pattern.h"
+
+#include <string.h>
+
+// furthest a pattern may be placed from the origin, and the largest run count of an RLE pattern. keeps every
+// coordinate the parsers compute well within a gol_pos
+#define GOL_PATTERN_LIMIT ((gol_pos)1 << 60)
+// longest RLE header line that's read (x = ..., y = ..., rule = ...), the rest of a longer one is skipped
+#define GOL_PATTERN_HEADER 256
+
+// PRIVATE
+// Adds a run of 'count' live cells of a pattern at (x, y) on the board, dropping the cells that are off the board
+// Possible errors (return value): GOL_ERR_OK
+static gol_err gol_pattern_run(struct gameoflife *game, gol_pos x, gol_pos y, gol_pos count) {
+    if (y < 0 || y >= game->rows || count <= 0) return GOL_ERR_OK;
+    gol_pos end = x + count;
+    if (x < 0) x = 0;
+    if (end > game->cols) end = game->cols;
+    if (end <= x) return GOL_ERR_OK;
+    return gol_setrun(game, x, y, end - x, true);
+}
+
+// PRIVATE
+// Skips the rest of the current line of the file
+static void gol_pattern_skipline(FILE *file) {
+    int c;
+    while ((c = getc(file)) != EOF && c != '\n');
+}
+
+// PRIVATE
+// Reads the rule out of an RLE header line ("x = 3, y = 3, rule = B3/S23") and applies it to the game
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (the rule isn't life-like), GOL_ERR_OK
+static gol_err gol_pattern_header(struct gameoflife *game, char *header) {
+    char *rule = strstr(header, "rule");
+    if (rule == NULL) return GOL_ERR_OK;
+    rule = strchr(rule, '=');
+    if (rule == NULL) return GOL_ERR_RANGE;
+
+    // the notation runs to the next comma or the end of the line, a bounded grid suffix (":T100,100") is ignored
+    rule++;
+    while (*rule == ' ' || *rule == '\t') rule++;
+    size_t len = strcspn(rule, ",: \t\r\n");
+    rule[len] = '\0';
+    return gol_setrule(game, rule);
+}
+
+// Adds the live cells of an RLE pattern read from the file to the board, placed at (x, y)
+// Comment lines (#) and the header line are read first, the runs after them are decoded as they're read: 'b' runs are
+// skipped, 'o' runs (and runs of any other letter, as for multi-state patterns) are set with gol_setrun, '$' ends rows
+// and '!' ends the pattern
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (malformed pattern, or one that's too far out),
+// GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_pattern_readrle(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y) {
+    gol_err error;
+    int c;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < -GOL_PATTERN_LIMIT || x > GOL_PATTERN_LIMIT || y < -GOL_PATTERN_LIMIT || y > GOL_PATTERN_LIMIT)
+        return GOL_ERR_RANGE;
+
+    // skip the comments until the header line
+    while ((c = getc(file)) == '#' || c == '\n' || c == '\r' || c == ' ' || c == '\t') {
+        if (c == '#') gol_pattern_skipline(file);
+    }
+    if (c != 'x') return ferror(file) ? GOL_ERR_IO : GOL_ERR_RANGE;
+    char header[GOL_PATTERN_HEADER];
+    size_t len = 0;
+    for (; c != EOF && c != '\n'; c = getc(file)) {
+        if (len + 1 < sizeof(header)) header[len++] = (char) c;
+    }
+    header[len] = '\0';
+    if ((error = gol_pattern_header(game, header)) != GOL_ERR_OK) return error;
+
+    // position within the pattern and the count of the next run (0 for none)
+    gol_pos px = 0, py = 0, count = 0;
+    while ((c = getc(file)) != EOF && c != '!') {
+        if (c >= '0' && c <= '9') {
+            // checked before it's multiplied, so a long run of digits can't overflow
+            if (count > (GOL_PATTERN_LIMIT - (c - '0')) / 10) return GOL_ERR_RANGE;
+            count = count * 10 + (c - '0');
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        if (c == '#') {
+            gol_pattern_skipline(file);
+            continue;
+        }
+
+        gol_pos run = count ? count : 1;
+        count = 0;
+        if (c == '$') {
+            py += run;
+            px = 0;
+        } else if (c == 'b' || c == '.') {
+            px += run;
+        } else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) {
+            if ((error = gol_pattern_run(game, x + px, y + py, run)) != GOL_ERR_OK) return error;
+            px += run;
+        } else {
+            return GOL_ERR_RANGE;
+        }
+        if (px > GOL_PATTERN_LIMIT || py > GOL_PATTERN_LIMIT) return GOL_ERR_RANGE;
+    }
+    if (ferror(file)) return GOL_ERR_IO;
+    // a count has to be followed by what it counts
+    return count ? GOL_ERR_RANGE : GOL_ERR_OK;
+}
+
+// Adds the live cells of a plaintext pattern read from the file to the board, placed at (x, y)
+// Every line is a row of the pattern, 'O' (or '*') for live cells and '.' for dead ones, except for comment lines
+// starting with '!'. rows may be shorter than the pattern is wide
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE (malformed pattern, or one that's too far out),
+// GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_pattern_readcells(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y) {
+    gol_err error;
+    int c;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < -GOL_PATTERN_LIMIT || x > GOL_PATTERN_LIMIT || y < -GOL_PATTERN_LIMIT || y > GOL_PATTERN_LIMIT)
+        return GOL_ERR_RANGE;
+
+    // position within the pattern, and the column the current run of live cells started at (-1 for none)
+    gol_pos px = 0, py = 0, run = -1;
+    bool line_start = true;
+    while ((c = getc(file)) != EOF) {
+        if (line_start && c == '!') {
+            gol_pattern_skipline(file);
+            continue;
+        }
+        line_start = false;
+        if (c == 'O' || c == '*') {
+            if (run < 0) run = px;
+            px++;
+            if (px > GOL_PATTERN_LIMIT) return GOL_ERR_RANGE;
+            continue;
+        }
+
+        // anything else ends the run
+        if (run >= 0 && (error = gol_pattern_run(game, x + run, y + py, px - run)) != GOL_ERR_OK) return error;
+        run = -1;
+        if (c == '.' || c == ' ') {
+            px++;
+        } else if (c == '\n') {
+            px = 0;
+            py++;
+            line_start = true;
+            if (py > GOL_PATTERN_LIMIT) return GOL_ERR_RANGE;
+        } else if (c != '\r' && c != '\t') {
+            return GOL_ERR_RANGE;
+        }
+    }
+    if (ferror(file)) return GOL_ERR_IO;
+    if (run >= 0) return gol_pattern_run(game, x + run, y + py, px - run);
+    return GOL_ERR_OK;
+}
+
+// Adds the live cells of a pattern read from the file to the board, placed at (x, y)
+// RLE patterns start with a '#' comment or their 'x = ' header, anything else is read as a plaintext pattern
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_pattern_read(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y) {
+    int c = getc(file);
+    if (c == EOF) return ferror(file) ? GOL_ERR_IO : GOL_ERR_OK;
+    if (ungetc(c, file) == EOF) return GOL_ERR_IO;
+    if (c == '#' || c == 'x') return gol_pattern_readrle(game, file, x, y);
+    return gol_pattern_readcells(game, file, x, y);
+}
+
+// Adds the live cells of the pattern file at 'path' to the board, placed at (x, y), see gol_pattern_read
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_pattern_load(struct gameoflife *game, const char *path, gol_pos x, gol_pos y) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) return GOL_ERR_IO;
+    gol_err error = gol_pattern_read(game, file, x, y);
+    fclose(file);
+    return error;
+}
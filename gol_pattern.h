@@ -0,0 +1,22 @@
+#ifndef C_PLAYGROUND_GOL_PATTERN_H
+#define C_PLAYGROUND_GOL_PATTERN_H
+
+#include "gol.h"
+
+// Pattern loaders for the run length encoded (.rle) and plaintext (.cells) formats of the LifeWiki pattern catalogue.
+// Files are parsed a character at a time as they're read, so patterns of any size load without buffering the file,
+// and every run of live cells is written to the board at once with gol_setrun.
+// The live cells of a pattern are added to the board, cells the pattern leaves dead are untouched. cells placed off
+// the board are dropped.
+
+// adds the live cells of an RLE pattern to the board, with the pattern's top left corner at (x, y)
+// a rule given in the pattern's header replaces the rule of the game
+gol_err gol_pattern_readrle(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y);
+// adds the live cells of a plaintext pattern to the board, with the pattern's top left corner at (x, y)
+gol_err gol_pattern_readcells(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y);
+// adds the live cells of a pattern in either format to the board, telling them apart by their first character
+gol_err gol_pattern_read(struct gameoflife *game, FILE *file, gol_pos x, gol_pos y);
+// adds the live cells of the pattern file at 'path' to the board, see gol_pattern_read
+gol_err gol_pattern_load(struct gameoflife *game, const char *path, gol_pos x, gol_pos y);
+
+#endif //C_PLAYGROUND_GOL_PATTERN_H
@@ -0,0 +1,402 @@
+#include "gol_snapshot.h"
+#include "gol_alloc.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GOL_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// first bytes of every snapshot, the last one is the version of the format
+static const char gol_snapshot_magic[8] = {'G', 'O', 'L', 'S', 'N', 'A', 'P', 1};
+
+// a run record of a compressed snapshot has this bit set in its length, and is followed by the one word it repeats
+// a literal record has it clear, and is followed by that many words
+#define GOL_RLE_REPEAT ((uint64_t)1 << 63)
+// most words a literal record is allowed to hold, the buffer the writer collects them in
+#define GOL_RLE_LITERALS 512
+
+// the header of a snapshot, decoded
+struct gol_snapshot {
+    uint32_t flags;
+    gol_boundary boundary;
+    gol_pos rows, cols;
+    uint64_t generation;
+    uint16_t birth, survive;
+    uint64_t words;
+};
+
+// PRIVATE
+// Checks whether words are stored little-endian in memory, like in snapshots
+static bool gol_littleendian(void) {
+    const uint16_t probe = 1;
+    return *(const unsigned char *) &probe == 1;
+}
+
+// PRIVATE
+// Stores/loads a little-endian 16, 32 or 64-bit value at 'p'
+static void gol_put64(unsigned char *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) p[i] = (unsigned char) (v >> (8 * i));
+}
+static uint64_t gol_get64(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+    return v;
+}
+
+// PRIVATE
+// Converts a word between the byte order of snapshots and the byte order of this machine (both ways)
+static uint64_t gol_swapword(uint64_t word) {
+    if (gol_littleendian()) return word;
+    unsigned char bytes[8];
+    memcpy(bytes, &word, sizeof(bytes));
+    return gol_get64(bytes);
+}
+
+// PRIVATE
+// Writes the header of a snapshot of the board to the file
+// Possible errors (return value): GOL_ERR_IO, GOL_ERR_OK
+static gol_err gol_snapshot_writeheader(const struct gameoflife *game, FILE *file, unsigned int flags) {
+    unsigned char header[GOL_SNAPSHOT_HEADER] = {0};
+    memcpy(header, gol_snapshot_magic, sizeof(gol_snapshot_magic));
+    gol_put64(header + 8, (uint64_t)flags | (uint64_t)game->boundary << 32);
+    gol_put64(header + 16, (uint64_t)game->rows);
+    gol_put64(header + 24, (uint64_t)game->cols);
+    gol_put64(header + 32, game->generation);
+    gol_put64(header + 40, (uint64_t)game->rule.birth | (uint64_t)game->rule.survive << 16);
+    gol_put64(header + 48, (uint64_t)(((size_t)game->cols + 63) / 64));
+    if (fwrite(header, 1, sizeof(header), file) != sizeof(header)) return GOL_ERR_IO;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Reads and checks the header of a snapshot
+// Possible errors (return value): GOL_ERR_IO, GOL_ERR_RANGE (not a snapshot, or a different version), GOL_ERR_OK
+static gol_err gol_snapshot_readheader(FILE *file, struct gol_snapshot *snapshot) {
+    unsigned char header[GOL_SNAPSHOT_HEADER];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) return GOL_ERR_IO;
+    if (memcmp(header, gol_snapshot_magic, sizeof(gol_snapshot_magic)) != 0) return GOL_ERR_RANGE;
+
+    uint64_t modes = gol_get64(header + 8), rule = gol_get64(header + 40);
+    snapshot->flags = (uint32_t)modes;
+    snapshot->boundary = (gol_boundary) (modes >> 32);
+    snapshot->rows = (gol_pos)gol_get64(header + 16);
+    snapshot->cols = (gol_pos)gol_get64(header + 24);
+    snapshot->generation = gol_get64(header + 32);
+    snapshot->birth = (uint16_t)rule;
+    snapshot->survive = (uint16_t)(rule >> 16);
+    snapshot->words = gol_get64(header + 48);
+    if (snapshot->flags & ~(uint32_t)GOL_SNAPSHOT_RLE) return GOL_ERR_RANGE;
+    if (snapshot->rows < 0 || snapshot->cols < 0) return GOL_ERR_RANGE;
+    if (snapshot->words != ((uint64_t)snapshot->cols + 63) / 64) return GOL_ERR_RANGE;
+    if (((snapshot->birth | snapshot->survive) >> 9) != 0) return GOL_ERR_RANGE;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Initializes the game for the snapshot, with its rule and boundary mode instead of the ones in opts
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_OK
+static gol_err gol_snapshot_init(struct gameoflife *game, const struct gol_snapshot *snapshot,
+                                 const struct gol_options *opts, gol_storage storage) {
+    gol_err error;
+    struct gol_options options = {0};
+    struct gol_rule rule = {snapshot->birth, snapshot->survive, {{false}}, false};
+    char notation[GOL_RULE_MAX];
+    if (opts != NULL) options = *opts;
+    gol_rulestring(&rule, notation);
+    options.rule = notation;
+    options.boundary = snapshot->boundary;
+    options.storage = storage;
+    if ((error = gol_init_opts(game, snapshot->rows, snapshot->cols, &options)) != GOL_ERR_OK) return error;
+    game->generation = snapshot->generation;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Provides row y of the board as little-endian packed words, converting a byte board into 'scratch'
+static const uint64_t *gol_snapshot_row(const struct gameoflife *game, gol_pos y, uint64_t *scratch) {
+    const size_t words = ((size_t)game->cols + 63) / 64;
+    if (game->storage == GOL_STORAGE_PACKED && gol_littleendian())
+        return game->packed + (size_t)y * words;
+
+    for (size_t w = 0; w < words; w++) {
+        uint64_t word = 0;
+        if (game->storage == GOL_STORAGE_PACKED) {
+            word = game->packed[(size_t)y * words + w];
+        } else {
+            const bool *row = game->board + (size_t)y * (size_t)game->cols + w * 64;
+            size_t count = (size_t)game->cols - w * 64 < 64 ? (size_t)game->cols - w * 64 : 64;
+            for (size_t x = 0; x < count; x++)
+                word |= (uint64_t)row[x] << x;
+        }
+        scratch[w] = gol_swapword(word);
+    }
+    return scratch;
+}
+
+// the state of the run-length encoder of gol_snapshot_write
+struct gol_rlewriter {
+    FILE *file;
+    // the words of the literal record being collected
+    uint64_t literals[GOL_RLE_LITERALS];
+    size_t count;
+    // the word of the current run and its length, which is 0 before the first word
+    uint64_t word;
+    uint64_t run;
+    bool failed;
+};
+
+// PRIVATE
+// Writes a record header and the words following it
+static void gol_rle_record(struct gol_rlewriter *rle, uint64_t header, const uint64_t *words, size_t count) {
+    unsigned char bytes[8];
+    gol_put64(bytes, header);
+    if (fwrite(bytes, 1, sizeof(bytes), rle->file) != sizeof(bytes)) rle->failed = true;
+    if (fwrite(words, sizeof(uint64_t), count, rle->file) != count) rle->failed = true;
+}
+
+// PRIVATE
+// Writes out the literal words collected so far
+static void gol_rle_flushliterals(struct gol_rlewriter *rle) {
+    if (rle->count == 0) return;
+    gol_rle_record(rle, rle->count, rle->literals, rle->count);
+    rle->count = 0;
+}
+
+// PRIVATE
+// Ends the current run, as a run record if it repeats its word or as another literal otherwise
+static void gol_rle_flushrun(struct gol_rlewriter *rle) {
+    if (rle->run >= 2) {
+        gol_rle_flushliterals(rle);
+        gol_rle_record(rle, GOL_RLE_REPEAT | rle->run, &rle->word, 1);
+    } else if (rle->run == 1) {
+        rle->literals[rle->count++] = rle->word;
+        if (rle->count == GOL_RLE_LITERALS) gol_rle_flushliterals(rle);
+    }
+    rle->run = 0;
+}
+
+// PRIVATE
+// Adds the next (little-endian) word of the board to the encoder
+static void gol_rle_push(struct gol_rlewriter *rle, uint64_t word) {
+    if (rle->run > 0 && word == rle->word && rle->run < ~GOL_RLE_REPEAT) {
+        rle->run++;
+        return;
+    }
+    gol_rle_flushrun(rle);
+    rle->word = word;
+    rle->run = 1;
+}
+
+// Writes a snapshot of the board to an open file, the row data is written straight from a packed board
+// With GOL_SNAPSHOT_RLE, runs of identical words are written as a single word and a count
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE (unknown flags), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_snapshot_write(const struct gameoflife *game, FILE *file, unsigned int flags) {
+    gol_err error;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (flags & ~(unsigned int)GOL_SNAPSHOT_RLE) return GOL_ERR_RANGE;
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+    if ((error = gol_snapshot_writeheader(game, file, flags)) != GOL_ERR_OK) return error;
+
+    // holds a row of a byte board (or the extra dead row) while it's written
+    const size_t words = ((size_t)game->cols + 63) / 64;
+    uint64_t *scratch = (uint64_t *) gol_zalloc(&game->allocator, words, sizeof(uint64_t));
+    if (scratch == NULL) return GOL_ERR_NOMEM;
+
+    error = GOL_ERR_OK;
+    if (flags & GOL_SNAPSHOT_RLE) {
+        struct gol_rlewriter *rle =
+                (struct gol_rlewriter *) gol_zalloc(&game->allocator, 1, sizeof(struct gol_rlewriter));
+        if (rle == NULL) {
+            gol_dealloc(&game->allocator, scratch);
+            return GOL_ERR_NOMEM;
+        }
+        rle->file = file;
+        for (gol_pos y = 0; y < game->rows; y++) {
+            const uint64_t *row = gol_snapshot_row(game, y, scratch);
+            for (size_t w = 0; w < words; w++)
+                gol_rle_push(rle, row[w]);
+        }
+        gol_rle_flushrun(rle);
+        gol_rle_flushliterals(rle);
+        if (rle->failed) error = GOL_ERR_IO;
+        gol_dealloc(&game->allocator, rle);
+    } else {
+        for (gol_pos y = 0; y < game->rows && error == GOL_ERR_OK; y++) {
+            if (fwrite(gol_snapshot_row(game, y, scratch), sizeof(uint64_t), words, file) != words) error = GOL_ERR_IO;
+        }
+        // the dead row after the board, which a mapped snapshot uses as its halo row
+        memset(scratch, 0, words * sizeof(uint64_t));
+        if (error == GOL_ERR_OK && fwrite(scratch, sizeof(uint64_t), words, file) != words) error = GOL_ERR_IO;
+    }
+    gol_dealloc(&game->allocator, scratch);
+    return error;
+}
+
+// Writes a snapshot of the board to the file at 'path', replacing it if it exists
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_snapshot_save(const struct gameoflife *game, const char *path, unsigned int flags) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return GOL_ERR_IO;
+    gol_err error = gol_snapshot_write(game, file, flags);
+    if (fclose(file) != 0 && error == GOL_ERR_OK) error = GOL_ERR_IO;
+    return error;
+}
+
+// PRIVATE
+// Decodes the run-length encoded words of a snapshot into 'out', 'count' words at a time
+// 'run' and 'word' carry a run (or the rest of a literal record, with 'literal' set) over to the next call
+// Possible errors (return value): GOL_ERR_IO, GOL_ERR_RANGE (corrupt snapshot), GOL_ERR_OK
+static gol_err gol_rle_read(FILE *file, uint64_t *out, size_t count, uint64_t *run, uint64_t *word, bool *literal) {
+    while (count > 0) {
+        if (*run == 0) {
+            unsigned char bytes[8];
+            if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) return GOL_ERR_IO;
+            uint64_t header = gol_get64(bytes);
+            *literal = !(header & GOL_RLE_REPEAT);
+            *run = header & ~GOL_RLE_REPEAT;
+            if (*run == 0) return GOL_ERR_RANGE;
+            if (!*literal && fread(word, sizeof(uint64_t), 1, file) != 1) return GOL_ERR_IO;
+        }
+        size_t n = *run < count ? (size_t)*run : count;
+        if (*literal) {
+            // literal words go straight into the row
+            if (fread(out, sizeof(uint64_t), n, file) != n) return GOL_ERR_IO;
+        } else {
+            for (size_t i = 0; i < n; i++) out[i] = *word;
+        }
+        out += n;
+        count -= n;
+        *run -= n;
+    }
+    return GOL_ERR_OK;
+}
+
+// Initializes the game from a snapshot in an open file, reading its rows into the board one at a time
+// opts supply the storage, threads and tile tracking to use (NULL for the defaults of gol_init)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE (not a snapshot, or corrupt), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_snapshot_read(struct gameoflife *game, FILE *file, const struct gol_options *opts) {
+    gol_err error;
+    struct gol_snapshot snapshot;
+    if ((error = gol_snapshot_readheader(file, &snapshot)) != GOL_ERR_OK) return error;
+    gol_storage storage = opts != NULL ? opts->storage : GOL_STORAGE_BYTES;
+    if ((error = gol_snapshot_init(game, &snapshot, opts, storage)) != GOL_ERR_OK) return error;
+
+    const size_t words = (size_t)snapshot.words;
+    uint64_t *scratch = (uint64_t *) gol_alloc(&game->allocator, words, sizeof(uint64_t));
+    if (scratch == NULL) {
+        gol_free(game);
+        return GOL_ERR_NOMEM;
+    }
+    uint64_t run = 0, word = 0;
+    bool literal = false;
+    for (gol_pos y = 0; y < game->rows; y++) {
+        uint64_t *row = game->storage == GOL_STORAGE_PACKED ? game->packed + (size_t)y * words : scratch;
+        if (snapshot.flags & GOL_SNAPSHOT_RLE)
+            error = gol_rle_read(file, row, words, &run, &word, &literal);
+        else if (fread(row, sizeof(uint64_t), words, file) != words)
+            error = GOL_ERR_IO;
+        if (error != GOL_ERR_OK) break;
+
+        for (size_t w = 0; w < words; w++)
+            row[w] = gol_swapword(row[w]);
+        // bits past the last column must stay dead, whatever the file says
+        if (words > 0 && game->cols % 64)
+            row[words - 1] &= ((uint64_t)1 << (game->cols % 64)) - 1;
+        if (game->storage == GOL_STORAGE_PACKED) continue;
+
+        bool *cells = game->board + (size_t)y * (size_t)game->cols;
+        for (gol_pos x = 0; x < game->cols; x++)
+            cells[x] = (row[x / 64] >> (x % 64)) & 1;
+    }
+    gol_dealloc(&game->allocator, scratch);
+    if (error != GOL_ERR_OK) {
+        gol_free(game);
+        return error;
+    }
+    return gol_markdirty(game);
+}
+
+// Initializes the game from the snapshot file at 'path', see gol_snapshot_read
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_snapshot_load(struct gameoflife *game, const char *path, const struct gol_options *opts) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return GOL_ERR_IO;
+    gol_err error = gol_snapshot_read(game, file, opts);
+    fclose(file);
+    return error;
+}
+
+// Initializes the game from an uncompressed snapshot file without reading it: the file is mapped copy-on-write and
+// its rows become the packed board as they are, so only the pages that are touched are ever read from disk, and
+// changes to the board never reach the file. The board is always packed, the other settings come from opts
+// Where the file can't be mapped (compressed snapshots, big-endian machines, or systems without mmap) the snapshot
+// is read with gol_snapshot_load instead
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_snapshot_map(struct gameoflife *game, const char *path, const struct gol_options *opts) {
+    struct gol_options options = {0};
+    if (opts != NULL) options = *opts;
+    options.storage = GOL_STORAGE_PACKED;
+#ifdef GOL_SNAPSHOT_MMAP
+    gol_err error;
+    struct gol_snapshot snapshot;
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) return GOL_ERR_IO;
+    error = gol_snapshot_readheader(file, &snapshot);
+    fclose(file);
+    if (error != GOL_ERR_OK) return error;
+    if ((snapshot.flags & GOL_SNAPSHOT_RLE) || !gol_littleendian())
+        return gol_snapshot_load(game, path, &options);
+
+    // the header, every row and the dead row after them have to be in the file
+    if (snapshot.words > 0 && (uint64_t)snapshot.rows + 1 > (SIZE_MAX - GOL_SNAPSHOT_HEADER) / 8 / snapshot.words)
+        return GOL_ERR_RANGE;
+    size_t size = GOL_SNAPSHOT_HEADER + ((size_t)snapshot.rows + 1) * (size_t)snapshot.words * sizeof(uint64_t);
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return GOL_ERR_IO;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < (uint64_t)size) {
+        close(fd);
+        return GOL_ERR_RANGE;
+    }
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // the mapping stays valid once the file is closed
+    close(fd);
+    if (mapping == MAP_FAILED) return GOL_ERR_NOMEM;
+
+    if ((error = gol_snapshot_init(game, &snapshot, &options, GOL_STORAGE_PACKED)) != GOL_ERR_OK) {
+        munmap(mapping, size);
+        return error;
+    }
+    // the rows of the snapshot replace the board allocated by gol_init_opts
+    gol_dealloc(&game->allocator, game->packed);
+    game->packed = (uint64_t *) ((unsigned char *) mapping + GOL_SNAPSHOT_HEADER);
+    game->mapping = mapping;
+    game->mapping_size = size;
+    game->mapped = game->packed;
+    // the rows are trusted to have dead padding bits like every snapshot gol_snapshot_write makes, checking them would
+    // read the whole file. the halo row is a single row though, so keep it dead whatever the file says
+    uint64_t *halo = game->packed + (size_t)game->rows * game->words;
+    for (size_t w = 0; w < game->words; w++) {
+        if (halo[w] != 0) halo[w] = 0;
+    }
+    return gol_markdirty(game);
+#else
+    return gol_snapshot_load(game, path, &options);
+#endif
+}
+
+// Unmaps a snapshot mapped by gol_snapshot_map
+void gol_snapshot_unmap(void *mapping, size_t size) {
+#ifdef GOL_SNAPSHOT_MMAP
+    munmap(mapping, size);
+#else
+    (void) mapping;
+    (void) size;
+#endif
+}
@@ -0,0 +1,35 @@
+#ifndef C_PLAYGROUND_GOL_SNAPSHOT_H
+#define C_PLAYGROUND_GOL_SNAPSHOT_H
+
+#include "gol.h"
+
+// Binary snapshots of a board: a GOL_SNAPSHOT_HEADER byte header holding the dimensions, rule, boundary mode and
+// generation of the board, followed by its rows bit-packed like GOL_STORAGE_PACKED (little-endian words).
+// Uncompressed snapshots end with one extra dead row, so they can be mapped straight into memory as a packed board
+// by gol_snapshot_map, with nothing to parse. Compressed snapshots run-length encode the words of the rows instead.
+
+// size of the header, which keeps the rows after it aligned for 64-bit words
+#define GOL_SNAPSHOT_HEADER 64
+
+// flags of gol_snapshot_save/gol_snapshot_write
+// run-length encode runs of identical words (usually dead space), such snapshots can't be mapped
+#define GOL_SNAPSHOT_RLE 1
+
+// writes the board to a snapshot file
+gol_err gol_snapshot_save(const struct gameoflife *game, const char *path, unsigned int flags);
+// writes the board as a snapshot to an open file
+gol_err gol_snapshot_write(const struct gameoflife *game, FILE *file, unsigned int flags);
+// initializes the game from a snapshot file, with the settings in opts (can be NULL) except for rule and boundary,
+// which are taken from the snapshot
+gol_err gol_snapshot_load(struct gameoflife *game, const char *path, const struct gol_options *opts);
+// initializes the game from a snapshot in an open file, like gol_snapshot_load
+gol_err gol_snapshot_read(struct gameoflife *game, FILE *file, const struct gol_options *opts);
+// initializes the game with the snapshot file mapped into memory as its packed board, which is read lazily as it's
+// ticked instead of parsed up front. the file is never written to. opts->storage is ignored
+gol_err gol_snapshot_map(struct gameoflife *game, const char *path, const struct gol_options *opts);
+
+// PRIVATE
+// releases a snapshot mapped by gol_snapshot_map, used by gol_free
+void gol_snapshot_unmap(void *mapping, size_t size);
+
+#endif //C_PLAYGROUND_GOL_SNAPSHOT_H
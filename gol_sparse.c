@@ -0,0 +1,384 @@
+#include "gol_sparse.h"
+#include "gol_alloc.h"
+#include "gol_kernel.h"
+
+#include <string.h>
+
+struct gol_chunk {
+    // chunk coordinates, the chunk covers cells [cx * GOL_CHUNK, (cx + 1) * GOL_CHUNK) on x (same for y)
+    gol_pos cx, cy;
+    // the current and next generation, bit x of word y is the cell at (x, y) within the chunk
+    uint64_t *cells;
+    uint64_t *next;
+    uint64_t buffers[2][GOL_CHUNK];
+    // next chunk in the same hash bucket (or in the freelist), and the position of the chunk in the list
+    struct gol_chunk *hnext;
+    size_t index;
+};
+
+// PRIVATE
+// Converts a cell coordinate to the coordinate of the chunk containing it (rounding towards negative infinity)
+static inline gol_pos gol_chunkof(gol_pos v) {
+    return v >= 0 ? v / GOL_CHUNK : -((-(v + 1)) / GOL_CHUNK) - 1;
+}
+
+// PRIVATE
+// Hashes chunk coordinates into a bucket of the table
+static inline size_t gol_chunkhash(const struct gol_sparse *sparse, gol_pos cx, gol_pos cy) {
+    uint64_t h = (uint64_t)cx * 0x9E3779B97F4A7C15ull ^ ((uint64_t)cy + 0x632BE59BD9B4E019ull) * 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 31;
+    return (size_t)h & (sparse->buckets - 1);
+}
+
+// PRIVATE
+// Provides the chunk at the chunk coordinates, or NULL if there isn't one
+static struct gol_chunk *gol_chunkfind(const struct gol_sparse *sparse, gol_pos cx, gol_pos cy) {
+    for (struct gol_chunk *c = sparse->table[gol_chunkhash(sparse, cx, cy)]; c != NULL; c = c->hnext) {
+        if (c->cx == cx && c->cy == cy) return c;
+    }
+    return NULL;
+}
+
+// PRIVATE
+// Doubles the number of buckets of the hash table, if that fails the table just stays more crowded
+static void gol_sparse_grow(struct gol_sparse *sparse) {
+    struct gol_chunk **table =
+        (struct gol_chunk **) gol_zalloc(&sparse->allocator, sparse->buckets * 2, sizeof(struct gol_chunk *));
+    if (table == NULL) return;
+
+    gol_dealloc(&sparse->allocator, sparse->table);
+    sparse->table = table;
+    sparse->buckets *= 2;
+    for (size_t i = 0; i < sparse->chunks; i++) {
+        struct gol_chunk *c = sparse->list[i];
+        size_t b = gol_chunkhash(sparse, c->cx, c->cy);
+        c->hnext = table[b];
+        table[b] = c;
+    }
+}
+
+// PRIVATE
+// Provides the chunk at the chunk coordinates, creating an empty one if there isn't one yet
+// Returns: The chunk, or NULL if out of memory
+static struct gol_chunk *gol_chunkget(struct gol_sparse *sparse, gol_pos cx, gol_pos cy) {
+    struct gol_chunk *c = gol_chunkfind(sparse, cx, cy);
+    if (c != NULL) return c;
+
+    if (sparse->chunks == sparse->capacity) {
+        size_t capacity = sparse->capacity ? sparse->capacity * 2 : 64;
+        struct gol_chunk **list =
+            (struct gol_chunk **) gol_alloc(&sparse->allocator, capacity, sizeof(struct gol_chunk *));
+        if (list == NULL) return NULL;
+        if (sparse->chunks > 0)
+            memcpy(list, sparse->list, sparse->chunks * sizeof(struct gol_chunk *));
+        gol_dealloc(&sparse->allocator, sparse->list);
+        sparse->list = list;
+        sparse->capacity = capacity;
+    }
+    if (sparse->freelist != NULL) {
+        c = sparse->freelist;
+        sparse->freelist = c->hnext;
+        sparse->spare--;
+    } else {
+        c = (struct gol_chunk *) gol_alloc(&sparse->allocator, 1, sizeof(struct gol_chunk));
+        if (c == NULL) return NULL;
+    }
+
+    memset(c->buffers, 0, sizeof(c->buffers));
+    c->cells = c->buffers[0];
+    c->next = c->buffers[1];
+    c->cx = cx;
+    c->cy = cy;
+    c->index = sparse->chunks;
+    sparse->list[sparse->chunks++] = c;
+    size_t b = gol_chunkhash(sparse, cx, cy);
+    c->hnext = sparse->table[b];
+    sparse->table[b] = c;
+
+    if (sparse->chunks > sparse->buckets) gol_sparse_grow(sparse);
+    return c;
+}
+
+// PRIVATE
+// Removes a chunk from the table and the list, keeping its memory around for the next chunk to be created
+static void gol_chunkremove(struct gol_sparse *sparse, struct gol_chunk *c) {
+    struct gol_chunk **link = &sparse->table[gol_chunkhash(sparse, c->cx, c->cy)];
+    while (*link != c) link = &(*link)->hnext;
+    *link = c->hnext;
+
+    // move the last chunk of the list into the free slot
+    struct gol_chunk *last = sparse->list[--sparse->chunks];
+    sparse->list[c->index] = last;
+    last->index = c->index;
+
+    c->hnext = sparse->freelist;
+    sparse->freelist = c;
+    sparse->spare++;
+}
+
+// PRIVATE
+// Frees the chunks kept for reuse beyond as many as are in use (or GOL_SPARSE_SPARE)
+static void gol_sparse_trim(struct gol_sparse *sparse) {
+    const size_t keep = sparse->chunks > GOL_SPARSE_SPARE ? sparse->chunks : GOL_SPARSE_SPARE;
+    while (sparse->spare > keep) {
+        struct gol_chunk *c = sparse->freelist;
+        sparse->freelist = c->hnext;
+        sparse->spare--;
+        gol_dealloc(&sparse->allocator, c);
+    }
+}
+
+// Initializes an empty, unbounded board whose chunks and tables come from the allocator (NULL for the system heap)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE (an allocator function is missing), GOL_ERR_OK
+gol_err gol_sparse_init(struct gol_sparse *sparse, const struct gol_allocator *allocator) {
+    gol_err error;
+    memset(sparse, 0, sizeof(struct gol_sparse));
+    if ((error = gol_allocator_init(&sparse->allocator, allocator)) != GOL_ERR_OK) return error;
+    sparse->rule = gol_conway;
+    sparse->buckets = 64;
+    sparse->table = (struct gol_chunk **) gol_zalloc(&sparse->allocator, sparse->buckets, sizeof(struct gol_chunk *));
+    if (sparse->table == NULL) return GOL_ERR_NOMEM;
+    return GOL_ERR_OK;
+}
+
+// Frees every chunk of the board and resets the struct
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_sparse_free(struct gol_sparse *sparse) {
+    for (size_t i = 0; i < sparse->chunks; i++)
+        gol_dealloc(&sparse->allocator, sparse->list[i]);
+    struct gol_chunk *c = sparse->freelist;
+    while (c != NULL) {
+        struct gol_chunk *next = c->hnext;
+        gol_dealloc(&sparse->allocator, c);
+        c = next;
+    }
+    gol_dealloc(&sparse->allocator, sparse->list);
+    gol_dealloc(&sparse->allocator, sparse->table);
+    memset(sparse, 0, sizeof(struct gol_sparse));
+    return GOL_ERR_OK;
+}
+
+// Reads the value of the cell at the provided coordinates into 'alive'
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_sparse_getcell(const struct gol_sparse *sparse, gol_pos x, gol_pos y, bool *alive) {
+    if (sparse->table == NULL) return GOL_ERR_INIT;
+
+    gol_pos cx = gol_chunkof(x), cy = gol_chunkof(y);
+    const struct gol_chunk *c = gol_chunkfind(sparse, cx, cy);
+    *alive = c != NULL && ((c->cells[y - cy * GOL_CHUNK] >> (x - cx * GOL_CHUNK)) & 1);
+    return GOL_ERR_OK;
+}
+
+// Sets the value of the cell at the provided coordinates
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_OK
+gol_err gol_sparse_setcell(struct gol_sparse *sparse, gol_pos x, gol_pos y, bool alive) {
+    if (sparse->table == NULL) return GOL_ERR_INIT;
+
+    gol_pos cx = gol_chunkof(x), cy = gol_chunkof(y);
+    struct gol_chunk *c = alive ? gol_chunkget(sparse, cx, cy) : gol_chunkfind(sparse, cx, cy);
+    if (c == NULL) return alive ? GOL_ERR_NOMEM : GOL_ERR_OK;
+
+    uint64_t *word = &c->cells[y - cy * GOL_CHUNK];
+    uint64_t bit = (uint64_t)1 << (x - cx * GOL_CHUNK);
+    if (((*word & bit) != 0) != alive) {
+        *word ^= bit;
+        sparse->population = alive ? sparse->population + 1 : sparse->population - 1;
+    }
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Reads the 64 cells of row y of the game from column x0 (anywhere, even off the board) into the bits of a word, bit i
+// for column x0 + i, the cells off the board dead
+static uint64_t gol_sparse_readword(const struct gameoflife *game, gol_pos x0, gol_pos y) {
+    gol_pos xa = x0 > 0 ? x0 : 0, xb = x0 + GOL_CHUNK < game->cols ? x0 + GOL_CHUNK : game->cols;
+    if (xa >= xb) return 0;
+    uint64_t word = 0;
+    if (game->storage == GOL_STORAGE_PACKED) {
+        // padding bits past the last column are always dead, so only the words past the row's end are left out
+        const uint64_t *row = game->packed + (size_t)y * game->words;
+        size_t w = (size_t)xa / 64;
+        word = row[w] >> (xa % 64);
+        if (xa % 64 != 0 && w + 1 < game->words) word |= row[w + 1] << (64 - xa % 64);
+        if (xb - xa < 64) word &= ((uint64_t)1 << (xb - xa)) - 1;
+    } else {
+        const bool *row = game->board + (size_t)y * (size_t)game->cols;
+        const bool *first = (const bool *) memchr(row + xa, true, (size_t)(xb - xa));
+        for (gol_pos x = first != NULL ? first - row : xb; x < xb; x++)
+            word |= (uint64_t)row[x] << (x - xa);
+    }
+    return word << (xa - x0);
+}
+
+// Replaces every cell of the board and its rule with those of 'game', placed with the game's cell (0, 0) at (x, y)
+// Only the bounding box of the live cells is read (see gol_bbox), a chunk row of 64 cells at a time, and chunks are
+// only created for the rows that have live cells
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE (B0 rule), GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_sparse_load(struct gol_sparse *sparse, const struct gameoflife *game, gol_pos x, gol_pos y) {
+    gol_err error;
+    if (sparse->table == NULL) return GOL_ERR_INIT;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    // only chunks near live cells are kept, so empty space has to stay empty
+    if (game->rule.birth & 1) return GOL_ERR_RANGE;
+    // the cells are read straight from host memory, so fetch them from a gpu first
+    if ((error = gol_sync(game)) != GOL_ERR_OK) return error;
+    gol_pos bx, by, bw, bh;
+    if ((error = gol_bbox(game, &bx, &by, &bw, &bh)) != GOL_ERR_OK) return error;
+
+    while (sparse->chunks > 0)
+        gol_chunkremove(sparse, sparse->list[sparse->chunks - 1]);
+    sparse->population = 0;
+    sparse->generation = 0;
+    sparse->rule = game->rule;
+
+    if (bw > 0 && bh > 0) {
+        // the chunk columns the bounding box lands on
+        const gol_pos cx0 = gol_chunkof(x + bx), cx1 = gol_chunkof(x + bx + bw - 1);
+        for (gol_pos gy = by; gy < by + bh; gy++) {
+            const gol_pos cy = gol_chunkof(y + gy);
+            for (gol_pos cx = cx0; cx <= cx1; cx++) {
+                uint64_t word = gol_sparse_readword(game, cx * GOL_CHUNK - x, gy);
+                if (word == 0) continue;
+                struct gol_chunk *c = gol_chunkget(sparse, cx, cy);
+                if (c == NULL) return GOL_ERR_NOMEM;
+                c->cells[y + gy - cy * GOL_CHUNK] = word;
+                sparse->population += (uint64_t)gol_popcount64(word);
+            }
+        }
+    }
+    gol_sparse_trim(sparse);
+    return GOL_ERR_OK;
+}
+
+// Clears 'game' and writes the live cells of the window of the board starting at (x, y) into it
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_OK
+gol_err gol_sparse_export(const struct gol_sparse *sparse, struct gameoflife *game, gol_pos x, gol_pos y) {
+    gol_err error;
+    if (sparse->table == NULL) return GOL_ERR_INIT;
+    if ((error = gol_clear(game)) != GOL_ERR_OK) return error;
+
+    for (size_t i = 0; i < sparse->chunks; i++) {
+        const struct gol_chunk *c = sparse->list[i];
+        gol_pos x0 = c->cx * GOL_CHUNK - x, y0 = c->cy * GOL_CHUNK - y;
+        // skip chunks entirely outside of the window
+        if (x0 >= game->cols || y0 >= game->rows || x0 + GOL_CHUNK <= 0 || y0 + GOL_CHUNK <= 0) continue;
+
+        for (gol_pos r = 0; r < GOL_CHUNK; r++) {
+            uint64_t word = c->cells[r];
+            while (word != 0) {
+                gol_pos col = (gol_pos)gol_popcount64((word & -word) - 1);
+                word &= word - 1;
+                if (x0 + col >= 0 && x0 + col < game->cols && y0 + r >= 0 && y0 + r < game->rows)
+                    gol_setcell(game, x0 + col, y0 + r, true);
+            }
+        }
+    }
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Creates the neighbors of a chunk that cells may be born into next generation, that is every neighbor across an
+// edge (or corner) of the chunk that has live cells on it
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_chunkexpand(struct gol_sparse *sparse, gol_pos cx, gol_pos cy, const uint64_t *cells) {
+    uint64_t any = 0;
+    for (int r = 0; r < GOL_CHUNK; r++) any |= cells[r];
+    if (any == 0) return GOL_ERR_OK;
+
+    const uint64_t top = cells[0], bottom = cells[GOL_CHUNK - 1];
+    const uint64_t west = 1, east = (uint64_t)1 << (GOL_CHUNK - 1);
+    // which neighbors are needed, indexed [dy + 1][dx + 1]
+    bool need[3][3] = {
+            {(top & west) != 0,    top != 0,    (top & east) != 0},
+            {(any & west) != 0,    false,       (any & east) != 0},
+            {(bottom & west) != 0, bottom != 0, (bottom & east) != 0},
+    };
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if (need[dy + 1][dx + 1] && gol_chunkget(sparse, cx + dx, cy + dy) == NULL) return GOL_ERR_NOMEM;
+        }
+    }
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Computes the next generation of a chunk into its 'next' buffer, reading the edges of its eight neighbors
+static void gol_chunktick(const struct gol_sparse *sparse, struct gol_chunk *c) {
+    static const uint64_t zero[GOL_CHUNK] = {0};
+    const uint64_t *around[3][3];
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            const struct gol_chunk *n = (dx || dy) ? gol_chunkfind(sparse, c->cx + dx, c->cy + dy) : c;
+            around[dy + 1][dx + 1] = n != NULL ? n->cells : zero;
+        }
+    }
+
+    // the columns of rows -1 to GOL_CHUNK, shifted so every bit lines up with the cell it borders
+    uint64_t lane_w[GOL_CHUNK + 2], lane_c[GOL_CHUNK + 2], lane_e[GOL_CHUNK + 2];
+    for (int r = -1; r <= GOL_CHUNK; r++) {
+        int band = r < 0 ? 0 : (r < GOL_CHUNK ? 1 : 2);
+        int row = r < 0 ? GOL_CHUNK - 1 : (r < GOL_CHUNK ? r : 0);
+        uint64_t w = around[band][0][row], m = around[band][1][row], e = around[band][2][row];
+        lane_w[r + 1] = (m << 1) | (w >> (GOL_CHUNK - 1));
+        lane_c[r + 1] = m;
+        lane_e[r + 1] = (m >> 1) | (e << (GOL_CHUNK - 1));
+    }
+
+    if (sparse->rule.conway) {
+        for (int r = 0; r < GOL_CHUNK; r++) {
+            c->next[r] = gol_wordnext(lane_w[r], lane_c[r], lane_e[r],
+                                      lane_w[r + 1], lane_c[r + 1], lane_e[r + 1],
+                                      lane_w[r + 2], lane_c[r + 2], lane_e[r + 2]);
+        }
+        return;
+    }
+    for (int r = 0; r < GOL_CHUNK; r++) {
+        c->next[r] = gol_wordrule(&sparse->rule, lane_w[r], lane_c[r], lane_e[r],
+                                  lane_w[r + 1], lane_c[r + 1], lane_e[r + 1],
+                                  lane_w[r + 2], lane_c[r + 2], lane_e[r + 2]);
+    }
+}
+
+// Provides the bytes of memory held by the board: its chunks (including the ones kept for reuse), list and hash table
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_sparse_memory(const struct gol_sparse *sparse, size_t *bytes) {
+    *bytes = (sparse->chunks + sparse->spare) * sizeof(struct gol_chunk)
+             + sparse->capacity * sizeof(struct gol_chunk *) + sparse->buckets * sizeof(struct gol_chunk *);
+    return GOL_ERR_OK;
+}
+
+// Ticks the board forward one generation
+// Chunks are added around the pattern wherever it could grow into them, and removed once they become empty
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_OK
+gol_err gol_sparse_tick(struct gol_sparse *sparse) {
+    gol_err error;
+    if (sparse->table == NULL) return GOL_ERR_INIT;
+
+    // make room for births across the edges of every chunk first, the chunks added here are ticked as well
+    size_t existing = sparse->chunks;
+    for (size_t i = 0; i < existing; i++) {
+        const struct gol_chunk *c = sparse->list[i];
+        if ((error = gol_chunkexpand(sparse, c->cx, c->cy, c->cells)) != GOL_ERR_OK) return error;
+    }
+
+    for (size_t i = 0; i < sparse->chunks; i++)
+        gol_chunktick(sparse, sparse->list[i]);
+
+    // swap in the next generation, dropping the chunks left empty
+    uint64_t population = 0;
+    for (size_t i = sparse->chunks; i-- > 0;) {
+        struct gol_chunk *c = sparse->list[i];
+        uint64_t *next = c->next;
+        c->next = c->cells;
+        c->cells = next;
+
+        uint64_t count = 0;
+        for (int r = 0; r < GOL_CHUNK; r++) count += gol_popcount64(c->cells[r]);
+        if (count == 0) gol_chunkremove(sparse, c);
+        population += count;
+    }
+    sparse->population = population;
+    sparse->generation++;
+    gol_sparse_trim(sparse);
+    return GOL_ERR_OK;
+}
@@ -0,0 +1,55 @@
+#ifndef C_PLAYGROUND_GOL_SPARSE_H
+#define C_PLAYGROUND_GOL_SPARSE_H
+
+#include "gol.h"
+
+// Sparse, unbounded board: only the GOL_CHUNK x GOL_CHUNK chunks that hold live cells (or may get some next generation)
+// are kept, in a hash map keyed by chunk coordinates. chunks are created as patterns grow into them and freed once
+// they are empty, so memory scales with the population rather than the area of its bounding box.
+
+// width and height of a chunk, each chunk row is a single 64-bit word
+#define GOL_CHUNK 64
+// chunks always kept for reuse by gol_sparse_tick, however few are in use
+#define GOL_SPARSE_SPARE 64
+
+struct gol_chunk;
+
+struct gol_sparse {
+    // hash table of the chunks by chunk coordinates, and every chunk in a flat list for iteration
+    struct gol_chunk **table;
+    size_t buckets;
+    struct gol_chunk **list;
+    size_t chunks;
+    size_t capacity;
+    // chunks to reuse instead of allocating new ones, at most about as many as there are chunks in use (see
+    // GOL_SPARSE_SPARE) so the memory of a pattern that dies down goes back
+    struct gol_chunk *freelist;
+    size_t spare;
+
+    uint64_t generation;
+    uint64_t population;
+    // the rule of the board the pattern was loaded from, B3/S23 until then
+    struct gol_rule rule;
+    // where the chunks and both tables come from
+    struct gol_allocator allocator;
+};
+
+// initializes an empty, unbounded board. Its memory comes from the allocator, NULL for the system heap, which is only
+// ever called from the thread calling gol_sparse_* functions
+gol_err gol_sparse_init(struct gol_sparse *sparse, const struct gol_allocator *allocator);
+// releases all chunks of the board (except for the provided pointer itself)
+gol_err gol_sparse_free(struct gol_sparse *sparse);
+// reads the cell at column x, row y into 'alive', any coordinate is valid
+gol_err gol_sparse_getcell(const struct gol_sparse *sparse, gol_pos x, gol_pos y, bool *alive);
+// sets the cell at column x, row y, allocating its chunk if needed
+gol_err gol_sparse_setcell(struct gol_sparse *sparse, gol_pos x, gol_pos y, bool alive);
+// replaces the board with the cells and the rule of 'game', placing the game's cell (0, 0) at (x, y)
+gol_err gol_sparse_load(struct gol_sparse *sparse, const struct gameoflife *game, gol_pos x, gol_pos y);
+// writes the cols x rows window starting at (x, y) into 'game'
+gol_err gol_sparse_export(const struct gol_sparse *sparse, struct gameoflife *game, gol_pos x, gol_pos y);
+// provides the bytes of memory held by the board
+gol_err gol_sparse_memory(const struct gol_sparse *sparse, size_t *bytes);
+// ticks the board forward one generation
+gol_err gol_sparse_tick(struct gol_sparse *sparse);
+
+#endif //C_PLAYGROUND_GOL_SPARSE_H
@@ -0,0 +1,166 @@
+#include "gol_term.h"
+#include "gol_alloc.h"
+
+#include <string.h>
+
+// a changed cell at most this many cells right of the cursor is reached by reprinting the cells in between, which
+// takes fewer bytes than moving the cursor
+#define GOL_TERM_SKIP 6
+
+// PRIVATE
+// Makes room for 'len' more bytes in the output buffer
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_term_reserve(struct gol_term *term, size_t len) {
+    if (term->out_cap - term->out_len >= len) return GOL_ERR_OK;
+
+    size_t capacity = term->out_cap ? term->out_cap : 4096;
+    while (capacity - term->out_len < len) capacity *= 2;
+    char *out = (char *) gol_alloc(&term->allocator, capacity, 1);
+    if (out == NULL) return GOL_ERR_NOMEM;
+    if (term->out_len > 0) memcpy(out, term->out, term->out_len);
+    gol_dealloc(&term->allocator, term->out);
+    term->out = out;
+    term->out_cap = capacity;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Appends 'len' bytes to the output buffer
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_term_append(struct gol_term *term, const char *data, size_t len) {
+    gol_err error;
+    if ((error = gol_term_reserve(term, len)) != GOL_ERR_OK) return error;
+    memcpy(term->out + term->out_len, data, len);
+    term->out_len += len;
+    return GOL_ERR_OK;
+}
+
+// PRIVATE
+// Appends the escape sequence moving the cursor to column x, row y of the board (both from 0)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_OK
+static gol_err gol_term_move(struct gol_term *term, gol_pos x, gol_pos y) {
+    char seq[48];
+    int len = snprintf(seq, sizeof(seq), "\x1b[%lld;%lldH", (long long) y + 1, (long long) x + 1);
+    return gol_term_append(term, seq, (size_t)len);
+}
+
+// Initializes the renderer, nothing is allocated until the first frame
+// For custom ALIVE/DEAD character, provide src with atleast 2 characters, otherwise NULL
+// The buffers are allocated through 'allocator', or the system heap if it's NULL
+// Possible errors (return value): GOL_ERR_RANGE (an allocator missing a function), GOL_ERR_OK
+gol_err gol_term_init(struct gol_term *term, const char *src, const struct gol_allocator *allocator) {
+    gol_err error;
+    memset(term, 0, sizeof(struct gol_term));
+    if ((error = gol_allocator_init(&term->allocator, allocator)) != GOL_ERR_OK) return error;
+    term->on_char = src != NULL ? src[0] : 'X';
+    term->off_char = src != NULL ? src[1] : 'O';
+    return GOL_ERR_OK;
+}
+
+// Frees the buffers of the renderer and resets the struct
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_term_free(struct gol_term *term) {
+    gol_dealloc(&term->allocator, term->screen);
+    gol_dealloc(&term->allocator, term->frame);
+    gol_dealloc(&term->allocator, term->out);
+    memset(term, 0, sizeof(struct gol_term));
+    return GOL_ERR_OK;
+}
+
+// Makes the next frame clear the terminal and draw every cell, for example after something else wrote to it
+// Possible errors (return value): GOL_ERR_OK
+gol_err gol_term_reset(struct gol_term *term) {
+    term->drawn = false;
+    return GOL_ERR_OK;
+}
+
+// Draws the w x h rectangle of the board starting at column x, row y to the terminal behind 'file' in a single write
+// The first frame (and any frame after the rectangle changed size or gol_term_reset) clears the terminal and draws the
+// rectangle in full, every other frame compares it with the last frame and only moves the cursor to the cells that
+// changed, reprinting short runs of unchanged cells instead of moving when that's shorter. The cursor is left below the
+// rectangle afterwards. Only the cells of the rectangle are read, so a window can follow a part of a huge board
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_RANGE (rectangle off the board), GOL_ERR_IO,
+// GOL_ERR_OK
+gol_err gol_term_drawregion(struct gol_term *term, const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w,
+                            gol_pos h, FILE *file) {
+    gol_err error;
+    size_t size;
+    if (game->board == NULL && game->packed == NULL) return GOL_ERR_INIT;
+    if (x < 0 || y < 0 || w < 0 || h < 0 || w > game->cols - x || h > game->rows - y) return GOL_ERR_RANGE;
+
+    // render the rectangle into the buffer of the new frame, growing both frames to fit it
+    gol_render_region(game, x, y, w, h, NULL, 0, &size, NULL);
+    if (size > term->size) {
+        // neither frame is kept, the next one is drawn in full
+        char *screen = (char *) gol_alloc(&term->allocator, size, 1);
+        char *frame = (char *) gol_alloc(&term->allocator, size, 1);
+        if (screen == NULL || frame == NULL) {
+            gol_dealloc(&term->allocator, screen);
+            gol_dealloc(&term->allocator, frame);
+            return GOL_ERR_NOMEM;
+        }
+        gol_dealloc(&term->allocator, term->screen);
+        gol_dealloc(&term->allocator, term->frame);
+        term->screen = screen;
+        term->frame = frame;
+        term->size = size;
+        term->drawn = false;
+    }
+    char chars[2] = {term->on_char, term->off_char};
+    if ((error = gol_render_region(game, x, y, w, h, term->frame, term->size, NULL, chars)) != GOL_ERR_OK)
+        return error;
+
+    if (term->rows != h || term->cols != w) term->drawn = false;
+    term->rows = h;
+    term->cols = w;
+    term->out_len = 0;
+
+    // each row of the text is w cells and a new line
+    const size_t stride = (size_t)w + 1;
+    if (!term->drawn) {
+        // clear the screen and draw every row from its first column
+        if ((error = gol_term_append(term, "\x1b[H\x1b[2J", 7)) != GOL_ERR_OK) return error;
+        for (gol_pos row = 0; row < h; row++) {
+            if ((error = gol_term_move(term, 0, row)) != GOL_ERR_OK) return error;
+            if ((error = gol_term_append(term, term->frame + (size_t)row * stride, (size_t)w)) != GOL_ERR_OK)
+                return error;
+        }
+    } else {
+        for (gol_pos row = 0; row < h; row++) {
+            const char *now = term->frame + (size_t)row * stride, *before = term->screen + (size_t)row * stride;
+            // column the cursor is at within this row, or -1 if it's elsewhere
+            gol_pos cursor = -1;
+            for (gol_pos col = 0; col < w; col++) {
+                if (now[col] == before[col]) continue;
+                if (cursor >= 0 && col - cursor <= GOL_TERM_SKIP) {
+                    // the cells up to this one are the same on screen, so printing them again changes nothing
+                    error = gol_term_append(term, now + cursor, (size_t)(col - cursor + 1));
+                } else if ((error = gol_term_move(term, col, row)) == GOL_ERR_OK) {
+                    error = gol_term_append(term, now + col, 1);
+                }
+                if (error != GOL_ERR_OK) return error;
+                cursor = col + 1;
+            }
+        }
+    }
+    if ((error = gol_term_move(term, 0, h)) != GOL_ERR_OK) return error;
+
+    if (fwrite(term->out, sizeof(char), term->out_len, file) != term->out_len || fflush(file) != 0) {
+        // no telling what made it to the screen
+        term->drawn = false;
+        return GOL_ERR_IO;
+    }
+
+    // the new frame is on screen now
+    char *screen = term->screen;
+    term->screen = term->frame;
+    term->frame = screen;
+    term->drawn = true;
+    return GOL_ERR_OK;
+}
+
+// Draws the whole board to the terminal behind 'file', see gol_term_drawregion
+// Possible errors (return value): GOL_ERR_INIT, GOL_ERR_NOMEM, GOL_ERR_IO, GOL_ERR_OK
+gol_err gol_term_draw(struct gol_term *term, const struct gameoflife *game, FILE *file) {
+    return gol_term_drawregion(term, game, 0, 0, game->cols, game->rows, file);
+}
@@ -0,0 +1,39 @@
+#ifndef C_PLAYGROUND_GOL_TERM_H
+#define C_PLAYGROUND_GOL_TERM_H
+
+#include "gol.h"
+
+// Terminal renderer: remembers the last frame it drew, and only sends the cells that changed since then, each
+// behind an ANSI cursor move. every frame is a single write, so boards redraw quickly even over slow connections.
+
+struct gol_term {
+    // characters for live and dead cells
+    char on_char, off_char;
+    // the text of the frame on screen and of the frame being drawn (see gol_render), and the size of both
+    char *screen;
+    char *frame;
+    size_t size;
+    // dimensions of the board (or rectangle of it) on screen, the next frame is drawn in full if they change
+    gol_pos rows, cols;
+    bool drawn;
+    // escape sequences and cells of the frame being drawn, kept between frames to reuse the allocation
+    char *out;
+    size_t out_len, out_cap;
+    // where the buffers are allocated
+    struct gol_allocator allocator;
+};
+
+// initializes the renderer, src holds the characters for live and dead cells like for gol_tostring (can be NULL)
+// the buffers are allocated through 'allocator', like those of a board (NULL for the system heap)
+gol_err gol_term_init(struct gol_term *term, const char *src, const struct gol_allocator *allocator);
+// releases the buffers of the renderer (except for the provided pointer itself)
+gol_err gol_term_free(struct gol_term *term);
+// draws the board, only writing the cells that changed since the last frame (or everything on the first frame)
+gol_err gol_term_draw(struct gol_term *term, const struct gameoflife *game, FILE *file);
+// draws the w x h rectangle of the board starting at column x, row y the same way, a window onto a larger board
+gol_err gol_term_drawregion(struct gol_term *term, const struct gameoflife *game, gol_pos x, gol_pos y, gol_pos w,
+                            gol_pos h, FILE *file);
+// forgets what's on screen, so the next frame clears the terminal and is drawn in full
+gol_err gol_term_reset(struct gol_term *term);
+
+#endif //C_PLAYGROUND_GOL_TERM_H
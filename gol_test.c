@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "gol.h"
+#include "gol_bench.h"
+#include "gol_pattern.h"
+
+// Correctness check of every engine: runs known patterns and random soups through each of them under every kernel,
+// and fails unless they all end on exactly the board the reference (gol_tick on a byte board with the scalar kernel)
+// ends on. Nothing is timed, so it runs the same under Debug and sanitizer builds as it does optimized.
+
+// the patterns the cases start from, besides the glider gun of gol_bench
+static const char test_blinker[] = "x = 3, y = 1\n3o!\n";
+static const char test_glider[] = "x = 3, y = 3\nbo$2bo$3o!\n";
+static const char test_rpentomino[] = "x = 3, y = 3\nb2o$2o$bo!\n";
+
+// settings from the command line
+struct test_settings {
+    // threads of the threaded engine (at least 4 are used) and how they are pinned
+    unsigned int threads;
+    gol_pinning pin;
+    // only the cases whose name holds this, if it's not NULL
+    const char *filter;
+    // whether a board can tick on a gpu here (see GOL_BACKEND_GPU), and it wasn't turned off with --no-gpu
+    bool gpu;
+    // the kernel given by --kernel, NULL to run every kernel
+    const char *kernel;
+};
+
+// a board every engine is run through, and compared with the reference
+struct test_case {
+    const char *name;
+    gol_pos size;
+    gol_boundary boundary;
+    // the rule the board runs (gol_options.rule), NULL for B3/S23
+    const char *rule;
+    // a pattern (RLE) with its top left corner at (x, y), or NULL for a random soup of the density
+    const char *rle;
+    gol_pos x, y;
+    double density;
+    uint64_t seed;
+    uint64_t generations;
+    // the population the reference has to end on, 0 if it isn't checked
+    uint64_t population;
+    // whether the cells stay clear of the edges of the board, so the unbounded engines end on the same board
+    bool contained;
+};
+
+// the blinker and glider come back to themselves (the glider 100 cells further), the gun grows a stream of gliders
+// and the r-pentomino settles at generation 1103. the soups hit every boundary mode, and the fixed size kernels. the
+// last cases run rules other than B3/S23: B36/S23 births on six neighbors as well, and B2/S, where no cell survives,
+// has the r-pentomino spread at the speed of light (staying clear of the edges for 150 generations)
+static const struct test_case test_cases[] = {
+        {"blinker",         64,   GOL_BOUNDARY_DEAD,   NULL,      test_blinker,     30,  30,  0,    0,  101,  3,   true},
+        {"glider",          256,  GOL_BOUNDARY_DEAD,   NULL,      test_glider,      8,   8,   0,    0,  400,  5,   true},
+        {"gun",             256,  GOL_BOUNDARY_DEAD,   NULL,      bench_gun,        8,   8,   0,    0,  300,  0,   true},
+        {"r-pentomino",     1024, GOL_BOUNDARY_DEAD,   NULL,      test_rpentomino,  512, 512, 0,    0,  1103, 116, true},
+        {"soup-200",        200,  GOL_BOUNDARY_DEAD,   NULL,      NULL,             0,   0,   0.37, 5,  500,  0,   false},
+        {"soup-256-torus",  256,  GOL_BOUNDARY_TORUS,  NULL,      NULL,             0,   0,   0.5,  6,  300,  0,   false},
+        {"soup-130-mirror", 130,  GOL_BOUNDARY_MIRROR, NULL,      NULL,             0,   0,   0.5,  7,  300,  0,   false},
+        {"soup-1024-torus", 1024, GOL_BOUNDARY_TORUS,  NULL,      NULL,             0,   0,   0.5,  8,  64,   0,   false},
+        {"soup-256-b36s23", 256,  GOL_BOUNDARY_DEAD,   "B36/S23", NULL,             0,   0,   0.37, 9,  300,  0,   false},
+        {"soup-200-b2s",    200,  GOL_BOUNDARY_TORUS,  "B2/S",    NULL,             0,   0,   0.1,  10, 200,  0,   false},
+        {"r-pentomino-b2s", 512,  GOL_BOUNDARY_DEAD,   "B2/S",    test_rpentomino,  256, 256, 0,    0,  150,  0,   true},
+};
+
+// builds the board a case starts from, a byte board
+static gol_err test_buildcase(struct gameoflife *game, const struct test_case *c) {
+    gol_err error;
+    struct gol_options opts = {0};
+    opts.boundary = c->boundary;
+    opts.rule = c->rule;
+    if ((error = gol_init_opts(game, c->size, c->size, &opts)) != GOL_ERR_OK) return error;
+    if (c->rle == NULL) return gol_populate_seeded(game, c->seed, c->density);
+    FILE *file = tmpfile();
+    if (file == NULL) return GOL_ERR_IO;
+    fputs(c->rle, file);
+    rewind(file);
+    error = gol_pattern_readrle(game, file, c->x, c->y);
+    fclose(file);
+    return error;
+}
+
+// compares two boards of the same size cell by cell, through the text of one row at a time, and provides the first
+// cell that differs
+static gol_err test_compare(const struct gameoflife *a, const struct gameoflife *b, bool *same, gol_pos *x,
+                            gol_pos *y) {
+    gol_err error = GOL_ERR_OK;
+    size_t size = (size_t)a->cols + 1;
+    char *row_a = (char *) malloc(size), *row_b = (char *) malloc(size);
+    *same = true;
+    if (row_a == NULL || row_b == NULL) error = GOL_ERR_NOMEM;
+    for (gol_pos row = 0; row < a->rows && error == GOL_ERR_OK && *same; row++) {
+        if ((error = gol_render_region(a, 0, row, a->cols, 1, row_a, size, NULL, NULL)) != GOL_ERR_OK ||
+            (error = gol_render_region(b, 0, row, b->cols, 1, row_b, size, NULL, NULL)) != GOL_ERR_OK)
+            break;
+        for (gol_pos col = 0; col < a->cols && *same; col++) {
+            if (row_a[col] == row_b[col]) continue;
+            *same = false;
+            *x = col;
+            *y = row;
+        }
+    }
+    free(row_a);
+    free(row_b);
+    return error;
+}
+
+// runs one engine through a case and compares the board it ends on with the reference
+// returns whether it failed
+static bool test_engine(const struct bench_engine *engine, const struct test_case *c,
+                        const struct gameoflife *start, const struct gameoflife *reference,
+                        const struct test_settings *settings) {
+    const struct gameoflife *cells = NULL;
+    struct bench_run run;
+    bool same = false;
+    gol_pos x = 0, y = 0;
+    memset(&run, 0, sizeof(run));
+    gol_err error = engine->setup(&run, start, settings->threads, settings->pin);
+    if (error == GOL_ERR_OK) error = engine->advance(&run, c->generations);
+    if (error == GOL_ERR_OK) error = engine->cells(&run, start, &cells);
+    if (error == GOL_ERR_OK) error = test_compare(reference, cells, &same, &x, &y);
+    engine->release(&run);
+
+    if (error != GOL_ERR_OK)
+        fprintf(stderr, "%s/%s (%s): failed with error %u\n", c->name, engine->name, gol_kernelname(), error);
+    else if (!same)
+        fprintf(stderr, "%s/%s (%s): cell (%lld, %lld) differs from the reference after %llu generations\n",
+                c->name, engine->name, gol_kernelname(), (long long) x, (long long) y,
+                (unsigned long long) c->generations);
+    return error != GOL_ERR_OK || !same;
+}
+
+// runs every case through every engine under every kernel the cpu supports (or the one given with --kernel)
+// returns the number of failures
+static int test_check(const struct test_settings *settings) {
+    static const char *kernels[] = {"scalar", "sse2", "avx2", "neon"};
+    // the threaded engine always gets several threads, however many cores there are
+    struct test_settings threaded = *settings;
+    if (threaded.threads < 4) threaded.threads = 4;
+    int failures = 0;
+
+    printf("checking every engine against gol_tick on a byte board with the scalar kernel\n");
+    for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+        const struct test_case *c = &test_cases[i];
+        if (settings->filter != NULL && strstr(c->name, settings->filter) == NULL) continue;
+
+        struct gameoflife start, reference;
+        struct gol_options opts = {0};
+        memset(&start, 0, sizeof(start));
+        memset(&reference, 0, sizeof(reference));
+        gol_err error = test_buildcase(&start, c);
+        gol_setkernel("scalar");
+        if (error == GOL_ERR_OK) error = bench_load(&reference, &start, &opts);
+        for (uint64_t n = 0; n < c->generations && error == GOL_ERR_OK; n++)
+            error = gol_tick(&reference);
+        uint64_t population = 0;
+        if (error == GOL_ERR_OK) error = gol_population(&reference, &population);
+        if (error != GOL_ERR_OK || (c->population != 0 && population != c->population)) {
+            fprintf(stderr, "%s: the reference failed (error %u, population %llu)\n", c->name, error,
+                    (unsigned long long) population);
+            gol_free(&start);
+            gol_free(&reference);
+            failures++;
+            continue;
+        }
+
+        unsigned int runs = 0, failed = 0;
+        bool first_kernel = true;
+        for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+            if (settings->kernel != NULL && strcmp(settings->kernel, kernels[k]) != 0) continue;
+            if (gol_setkernel(kernels[k]) != GOL_ERR_OK) continue;
+            for (size_t e = 0; e < bench_engine_count; e++) {
+                const struct bench_engine *engine = &bench_engines[e];
+                if (engine->gpu && !settings->gpu) continue;
+                // the unbounded engines don't use the kernels, so they only run once
+                if (engine->unbounded && (!c->contained || !first_kernel)) continue;
+                failed += test_engine(engine, c, &start, &reference, engine->threaded ? &threaded : settings);
+                runs++;
+            }
+            first_kernel = false;
+        }
+        printf("%-16s %5llu generations %4u runs  %s\n", c->name, (unsigned long long) c->generations, runs,
+               failed ? "FAILED" : "ok");
+        fflush(stdout);
+        failures += (int) failed;
+        gol_free(&start);
+        gol_free(&reference);
+    }
+    gol_setkernel(settings->kernel);
+    return failures;
+}
+
+static void test_usage(const char *name) {
+    fprintf(stderr, "usage: %s [--kernel NAME] [--threads N] [--pin none|cores|nodes] [--filter TEXT] [--no-gpu]\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    struct test_settings settings = {4, GOL_PIN_NONE, NULL, bench_hasgpu(), NULL};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            if (gol_setkernel(argv[++i]) != GOL_ERR_OK) {
+                fprintf(stderr, "unknown or unsupported kernel: %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            settings.kernel = argv[i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            settings.threads = (unsigned int) strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "none") == 0) settings.pin = GOL_PIN_NONE;
+            else if (strcmp(argv[i], "cores") == 0) settings.pin = GOL_PIN_CORES;
+            else if (strcmp(argv[i], "nodes") == 0) settings.pin = GOL_PIN_NODES;
+            else {
+                test_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            settings.filter = argv[++i];
+        } else if (strcmp(argv[i], "--no-gpu") == 0) {
+            settings.gpu = false;
+        } else if (strcmp(argv[i], "--help") == 0) {
+            test_usage(argv[0]);
+            return EXIT_SUCCESS;
+        } else {
+            test_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    return test_check(&settings) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
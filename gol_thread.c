@@ -0,0 +1,250 @@
+#if defined(__linux__)
+// for pthread_setaffinity_np and the cpu_set_t macros
+#define _GNU_SOURCE
+#define GOL_POOL_AFFINITY
+#endif
+
+#include "gol_thread.h"
+#include "gol_alloc.h"
+
+#include <stdio.h>
+#include <pthread.h>
+#ifdef GOL_POOL_AFFINITY
+#include <sched.h>
+#endif
+
+// what each spawned worker is started with
+struct gol_worker {
+    struct gol_pool *pool;
+    unsigned int index;
+    pthread_t thread;
+#ifdef GOL_POOL_AFFINITY
+    // the cpus the worker pins itself to, if 'pinned'
+    cpu_set_t cpus;
+    bool pinned;
+#endif
+};
+
+struct gol_pool {
+    unsigned int size;
+    // one per worker, allocated (and released) by the thread creating the pool, as the allocator is never called from
+    // the workers. the first is unused, worker 0 being that thread
+    struct gol_worker *workers;
+    struct gol_allocator allocator;
+
+    pthread_mutex_t lock;
+    // signalled when a new task is posted (or the pool is stopping)
+    pthread_cond_t start;
+    // signalled when the last worker finishes the current task
+    pthread_cond_t done;
+
+    // the task being run, and a counter bumped every time a new one is posted
+    gol_task_fn task;
+    void *arg;
+    unsigned long generation;
+    // number of spawned workers still running the current task
+    unsigned int pending;
+    bool stop;
+#ifdef GOL_POOL_AFFINITY
+    // the thread that created the pool and was pinned as worker 0, and the cpus it ran on before, if 'pinned'
+    pthread_t owner;
+    cpu_set_t owner_cpus;
+    bool pinned;
+#endif
+};
+
+#ifdef GOL_POOL_AFFINITY
+// PRIVATE
+// Reads a list of cpus in the format of sysfs ("0-3,8,10-11") from the file at 'path' into 'set'
+// Returns: Whether the file exists and lists any cpu the process may run on (those in 'allowed')
+static bool gol_pool_cpulist(const char *path, const cpu_set_t *allowed, cpu_set_t *set) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) return false;
+    CPU_ZERO(set);
+    unsigned int first, last;
+    int c = ',';
+    while (c == ',' && fscanf(file, "%u", &first) == 1) {
+        last = first;
+        if ((c = getc(file)) == '-') {
+            if (fscanf(file, "%u", &last) != 1) break;
+            c = getc(file);
+        }
+        for (unsigned int cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+            CPU_SET(cpu, set);
+    }
+    fclose(file);
+    CPU_AND(set, set, allowed);
+    return CPU_COUNT(set) > 0;
+}
+
+// PRIVATE
+// Picks the cpus worker 'index' of 'workers' is pinned to (see gol_pinning)
+// Returns: Whether the worker is pinned at all, which it isn't without GOL_PIN_CORES or GOL_PIN_NODES
+static bool gol_pool_cpus(gol_pinning pin, unsigned int index, unsigned int workers, cpu_set_t *set) {
+    cpu_set_t allowed;
+    if (pin == GOL_PIN_NONE || sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) return false;
+
+    if (pin == GOL_PIN_CORES) {
+        // the index-th cpu the process may run on, round and round
+        unsigned int n = (unsigned int) CPU_COUNT(&allowed), nth = index % n;
+        CPU_ZERO(set);
+        for (unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed) && nth-- == 0) {
+                CPU_SET(cpu, set);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // the nodes with cpus the process may run on, the workers are split into as many consecutive groups, so the bands
+    // of rows of each group (and the memory they touch first) are on one node
+    cpu_set_t nodes[64];
+    unsigned int count = 0;
+    char path[64];
+    for (unsigned int node = 0; node < 1024 && count < 64; node++) {
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+        if (gol_pool_cpulist(path, &allowed, &nodes[count])) count++;
+    }
+    // no numa information (or a single node) leaves the scheduler free to pick any allowed cpu
+    if (count == 0) return false;
+    *set = nodes[(size_t)index * count / workers];
+    return true;
+}
+#endif
+
+// PRIVATE
+// Main loop of a spawned worker: waits for a task, runs it, and reports back until the pool is stopped
+static void *gol_pool_worker(void *param) {
+    const struct gol_worker *worker = (const struct gol_worker *) param;
+    struct gol_pool *pool = worker->pool;
+    unsigned int index = worker->index;
+#ifdef GOL_POOL_AFFINITY
+    if (worker->pinned)
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &worker->cpus);
+#endif
+
+    unsigned long seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen)
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) break;
+        seen = pool->generation;
+
+        gol_task_fn task = pool->task;
+        void *arg = pool->arg;
+        pthread_mutex_unlock(&pool->lock);
+
+        task(arg, index, pool->size);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Starts a pool with 'threads' workers, the thread calling gol_pool_run being one of them
+// Pinning only works on linux, elsewhere (or if the cpus can't be found) the workers run wherever the scheduler puts them
+// The pool and its workers are allocated through 'allocator' (the system heap if it's NULL)
+// Possible errors (return value): GOL_ERR_NOMEM, GOL_ERR_RANGE (an allocator missing a function), GOL_ERR_OK
+gol_err gol_pool_create(struct gol_pool **dest, unsigned int threads, gol_pinning pin,
+                        const struct gol_allocator *allocator) {
+    gol_err error;
+    if (threads == 0) threads = 1;
+
+    struct gol_allocator heap;
+    if ((error = gol_allocator_init(&heap, allocator)) != GOL_ERR_OK) return error;
+    struct gol_pool *pool = (struct gol_pool *) gol_zalloc(&heap, 1, sizeof(struct gol_pool));
+    if (pool == NULL) return GOL_ERR_NOMEM;
+    pool->allocator = heap;
+    pool->workers = (struct gol_worker *) gol_zalloc(&heap, threads, sizeof(struct gol_worker));
+    if (pool->workers == NULL) {
+        gol_dealloc(&heap, pool);
+        return GOL_ERR_NOMEM;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // spawn every worker except the first, which is the caller of gol_pool_run
+    pool->size = 1;
+    for (unsigned int i = 1; i < threads; i++) {
+        struct gol_worker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+#ifdef GOL_POOL_AFFINITY
+        worker->pinned = gol_pool_cpus(pin, i, threads, &worker->cpus);
+#endif
+        if (pthread_create(&worker->thread, NULL, gol_pool_worker, worker) != 0) break;
+        pool->size++;
+    }
+    if (pool->size != threads) {
+        gol_pool_destroy(pool);
+        return GOL_ERR_NOMEM;
+    }
+#ifdef GOL_POOL_AFFINITY
+    // worker 0 is the calling thread, which gets its own cpus back when the pool is destroyed
+    cpu_set_t cpus;
+    pool->owner = pthread_self();
+    if (gol_pool_cpus(pin, 0, threads, &cpus) &&
+        pthread_getaffinity_np(pool->owner, sizeof(cpu_set_t), &pool->owner_cpus) == 0)
+        pool->pinned = pthread_setaffinity_np(pool->owner, sizeof(cpu_set_t), &cpus) == 0;
+#else
+    (void) pin;
+#endif
+
+    *dest = pool;
+    return GOL_ERR_OK;
+}
+
+// Runs the task on all workers of the pool (including the caller as worker 0) and returns once every one is done
+void gol_pool_run(struct gol_pool *pool, gol_task_fn task, void *arg) {
+    if (pool->size > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->task = task;
+        pool->arg = arg;
+        pool->pending = pool->size - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    task(arg, 0, pool->size);
+
+    if (pool->size > 1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->pending != 0)
+            pthread_cond_wait(&pool->done, &pool->lock);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+unsigned int gol_pool_size(const struct gol_pool *pool) {
+    return pool->size;
+}
+
+// Stops every spawned worker, waits for them to exit, unpins the thread that created the pool and frees the pool
+void gol_pool_destroy(struct gol_pool *pool) {
+    if (pool == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (unsigned int i = 1; i < pool->size; i++)
+        pthread_join(pool->workers[i].thread, NULL);
+#ifdef GOL_POOL_AFFINITY
+    if (pool->pinned)
+        pthread_setaffinity_np(pool->owner, sizeof(cpu_set_t), &pool->owner_cpus);
+#endif
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    const struct gol_allocator heap = pool->allocator;
+    gol_dealloc(&heap, pool->workers);
+    gol_dealloc(&heap, pool);
+}
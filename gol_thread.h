@@ -0,0 +1,26 @@
+#ifndef C_PLAYGROUND_GOL_THREAD_H
+#define C_PLAYGROUND_GOL_THREAD_H
+
+// PRIVATE
+// Persistent worker pool used by gol_tick to process row bands in parallel. Not part of the public API.
+
+#include "gol.h"
+
+struct gol_pool;
+
+// a task run by every worker of the pool, 'worker' is in [0, workers)
+typedef void (*gol_task_fn)(void *arg, unsigned int worker, unsigned int workers);
+
+// starts a pool with the provided number of workers (the calling thread is worker 0, so threads - 1 are spawned), each
+// pinned to cpus as 'pin' asks. the calling thread runs on the cpus it had before again once the pool is destroyed
+// the pool's memory comes from 'allocator' (NULL for the system heap), only ever called from the calling thread
+gol_err gol_pool_create(struct gol_pool **pool, unsigned int threads, gol_pinning pin,
+                        const struct gol_allocator *allocator);
+// runs the task on every worker and waits until all of them have finished it
+void gol_pool_run(struct gol_pool *pool, gol_task_fn task, void *arg);
+// provides the number of workers in the pool
+unsigned int gol_pool_size(const struct gol_pool *pool);
+// stops and joins all workers, restores the cpus of the thread that created the pool, then frees the pool
+void gol_pool_destroy(struct gol_pool *pool);
+
+#endif //C_PLAYGROUND_GOL_THREAD_H
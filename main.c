@@ -1,7 +1,10 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include "gol.h"
+#include "gol_async.h"
+#include "gol_term.h"
 
 #define ROWS 30
 #define COLS 120
@@ -11,20 +14,31 @@
 
 #include <Windows.h>
 
-#define seed_rand srand(GetTickCount())
+#define time_seed ((uint64_t)GetTickCount64())
 #else
 #include <sys/time.h>
-#define seed_rand {\
-    struct timeval _time;\
-    gettimeofday(&_time, NULL);\
-    srand((_time.tv_sec * 1000) + (time.tv_usec / 1000));\
+
+static uint64_t time_seed_now(void) {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    return ((uint64_t)now.tv_sec * 1000000) + (uint64_t)now.tv_usec;
 }
+
+#define time_seed time_seed_now()
 #endif
 
+// the renderer draws with ANSI escape sequences, which the windows console only understands once asked to
 #ifdef WIN32
-#define CLEAR_CONSOLE system("cls")
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#define enable_ansi {\
+    HANDLE _console = GetStdHandle(STD_OUTPUT_HANDLE);\
+    DWORD _mode = 0;\
+    if (GetConsoleMode(_console, &_mode)) SetConsoleMode(_console, _mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);\
+}
 #else
-#define CLEAR_CONSOLE system("clear")
+#define enable_ansi
 #endif
 
 // a non-implementation defined function to wait for the number of milliseconds provided for the calling thread
@@ -41,33 +55,82 @@ static int wait_ms(int ms) {
 #endif
 }
 
-int main(void) {
-    // generate a reliable random seed using the definition
-    seed_rand;
+// ticks the board on a thread of its own as fast as it goes, and draws the newest generation every 100 ms
+static int run_async(struct gameoflife *game, struct gol_term *term) {
+    struct gol_async async;
+    if (gol_async_start(&async, game, 1) != GOL_ERR_OK) return EXIT_FAILURE;
+    int status = EXIT_SUCCESS;
+    // the simulation thread stops on the first tick that fails, which is reported once it's joined
+    while (gol_async_error(&async) == GOL_ERR_OK) {
+        const struct gameoflife *latest = gol_async_latest(&async);
+        if (gol_term_draw(term, latest, stdout) != GOL_ERR_OK) {
+            status = EXIT_FAILURE;
+            break;
+        }
+        printf("\x1b[Kgeneration %llu\n", (unsigned long long) latest->generation);
+
+        // if the wait is unsuccessful, then break
+        if (wait_ms(100) != 0)
+            break;
+    }
+    gol_err error = gol_async_stop(&async);
+    if (error != GOL_ERR_OK) {
+        fprintf(stderr, "ticking the board failed (error %d)\n", (int) error);
+        status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+int main(int argc, char **argv) {
+    // a seed can be passed to replay a board, otherwise one is generated from the time
+    // --async ticks the board as fast as it goes instead of one generation per frame
+    uint64_t seed = time_seed;
+    bool async = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--async") == 0)
+            async = true;
+        else
+            seed = strtoull(argv[i], NULL, 10);
+    }
 
     // setup the initial game
     struct gameoflife game;
     if (gol_init(&game, ROWS, COLS) != GOL_ERR_OK) return EXIT_FAILURE;
 
-    // populate the grid randomly
-    if (gol_populate(&game) != GOL_ERR_OK) return EXIT_FAILURE;
+    // populate the grid randomly, half the cells alive
+    if (gol_populate_seeded(&game, seed, 0.5) != GOL_ERR_OK) return EXIT_FAILURE;
 
-    char *game_str;
-    while (TRUE) {
-        // print the board as a string
-        if (gol_tostring(&game, &game_str, "X ") != GOL_ERR_OK) return EXIT_FAILURE;
-        printf("%s", game_str);
-        free(game_str);
+    // draw the board in place, only redrawing the cells that changed each frame
+    struct gol_term term;
+    enable_ansi;
+    gol_term_init(&term, "X ", NULL);
+    if (async) {
+        int status = run_async(&game, &term);
+        gol_term_free(&term);
+        gol_free(&game);
+        return status;
+    }
+    int status = EXIT_SUCCESS;
+    while (true) {
+        if (gol_term_draw(&term, &game, stdout) != GOL_ERR_OK) {
+            status = EXIT_FAILURE;
+            break;
+        }
 
         // if the wait is unsuccessful, then break
         if (wait_ms(100) != 0)
             break;
 
-        gol_tick(&game);
-        CLEAR_CONSOLE;
+        gol_err error = gol_tick(&game);
+        if (error != GOL_ERR_OK) {
+            fprintf(stderr, "ticking the board failed (error %d)\n", (int) error);
+            status = EXIT_FAILURE;
+            break;
+        }
     }
 
+    gol_term_free(&term);
     gol_free(&game);
 
-    return EXIT_SUCCESS;
+    return status;
 }